@@ -0,0 +1,477 @@
+/*
+ *  Judo - Embeddable JSON and JSON5 parser.
+ *  Copyright (c) 2025 Railgun Labs, LLC
+ *
+ *  This software is dual-licensed: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3 as
+ *  published by the Free Software Foundation. For the terms of this
+ *  license, see <https://www.gnu.org/licenses/>.
+ *
+ *  Alternatively, you can license this software under a proprietary
+ *  license, as set out in <https://railgunlabs.com/judo/license/>.
+ */
+
+// This program measures the throughput of the library on the JSON source
+// text of a file. The first argument selects what is compared:
+//
+//   utf8    Scanning with the per-character DFA decoder versus validating
+//           the input upfront with judo_prevalidate() and then scanning.
+//   spans   The layout and the scanning and parsing throughput with the
+//           configured span width. Build once with JUDO_ENABLE_WIDE_SPANS
+//           and once without it to compare 32-bit and 64-bit spans.
+//   numbers judo_numberify() versus the strtod() family of the C library
+//           on every number of the input, and whether their results agree.
+//
+// Each measurement is the best of several rounds. Build the library in
+// release mode for meaningful results.
+
+// This code does not attempt to be MISRA compliant.
+
+#include "judo.h"
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ROUNDS 5
+
+// Every measured round processes at least this many bytes so the
+// coarse resolution of clock() doesn't dominate small inputs.
+#define ROUND_BYTES ((size_t)64 * 1024 * 1024)
+
+// Reads the whole file into memory. Unlike judo_readstdin() this isn't
+// limited to 10 megabytes so the measurements can use large documents.
+static char *read_file(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    char *buffer = NULL;
+    size_t length = 0;
+    size_t capacity = 0;
+    for (;;)
+    {
+        if (length == capacity)
+        {
+            capacity = (capacity == 0u) ? 65536u : (capacity * 2u);
+            char *grown = realloc(buffer, capacity);
+            if (grown == NULL)
+            {
+                free(buffer);
+                buffer = NULL;
+                break;
+            }
+            buffer = grown;
+        }
+
+        const size_t bytes_read = fread(&buffer[length], 1, capacity - length, file);
+        length += bytes_read;
+        if (bytes_read == 0u)
+        {
+            break;
+        }
+    }
+
+    if ((buffer != NULL) && ferror(file))
+    {
+        free(buffer);
+        buffer = NULL;
+    }
+    (void)fclose(file);
+    *size = length;
+    return buffer;
+}
+
+static double seconds(void)
+{
+    return (double)clock() / (double)CLOCKS_PER_SEC;
+}
+
+static size_t repetitions(size_t bytes)
+{
+    size_t count = 1;
+    if ((bytes > 0u) && (bytes < ROUND_BYTES))
+    {
+        count = ROUND_BYTES / bytes;
+    }
+    return count;
+}
+
+static void report(const char *label, size_t bytes, double elapsed)
+{
+    const double megabytes = (double)bytes / (1024.0 * 1024.0);
+    printf("  %-28s %10.1f MB/s\n", label, (elapsed > 0.0) ? (megabytes / elapsed) : 0.0);
+}
+
+// A workload processes the whole input once and returns false on error.
+typedef bool (*workload)(const char *json, size_t json_len);
+
+// Runs the workload 'count' times per round and returns the fastest round in
+// seconds or a negative number if the workload failed.
+static double measure(workload run, const char *json, size_t json_len, size_t count)
+{
+    double best = -1.0;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        const double start = seconds();
+        for (size_t i = 0; i < count; i++)
+        {
+            if (!run(json, json_len))
+            {
+                return -1.0;
+            }
+        }
+        const double elapsed = seconds() - start;
+        if ((best < 0.0) || (elapsed < best))
+        {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+// Scans every token of the input with a stream that may have been prevalidated.
+static bool scan_stream(struct judo_stream *stream, const char *json, size_t json_len)
+{
+    for (;;)
+    {
+        if (judo_scan(stream, json, json_len) != JUDO_RESULT_SUCCESS)
+        {
+            fprintf(stderr, "error: %s\n", stream->error);
+            return false;
+        }
+        if (stream->token == JUDO_TOKEN_EOF)
+        {
+            break;
+        }
+    }
+    return true;
+}
+
+static bool run_scan(const char *json, size_t json_len)
+{
+    struct judo_stream stream = {0};
+    return scan_stream(&stream, json, json_len);
+}
+
+static bool run_prevalidate(const char *json, size_t json_len)
+{
+    struct judo_stream stream = {0};
+    if (judo_prevalidate(&stream, json, json_len) != JUDO_RESULT_SUCCESS)
+    {
+        fprintf(stderr, "error: %s\n", stream.error);
+        return false;
+    }
+    return true;
+}
+
+static bool run_prevalidate_scan(const char *json, size_t json_len)
+{
+    struct judo_stream stream = {0};
+    if (judo_prevalidate(&stream, json, json_len) != JUDO_RESULT_SUCCESS)
+    {
+        fprintf(stderr, "error: %s\n", stream.error);
+        return false;
+    }
+    return scan_stream(&stream, json, json_len);
+}
+
+static int bench_utf8(const char *json, size_t json_len)
+{
+    static const struct
+    {
+        const char *label;
+        workload run;
+    } cases[] = {
+        {"scan (DFA decoder)", run_scan},
+        {"prevalidate only", run_prevalidate},
+        {"prevalidate + scan", run_prevalidate_scan},
+    };
+
+    const size_t count = repetitions(json_len);
+    for (size_t i = 0; i < (sizeof(cases) / sizeof(cases[0])); i++)
+    {
+        const double elapsed = measure(cases[i].run, json, json_len, count);
+        if (elapsed < 0.0)
+        {
+            return 1;
+        }
+        report(cases[i].label, json_len * count, elapsed);
+    }
+    return 0;
+}
+
+#if defined(JUDO_PARSER)
+static size_t tree_bytes;
+
+static void *counting_memfunc(void *user_data, void *ptr, size_t size)
+{
+    (void)user_data;
+    if (ptr == NULL)
+    {
+        tree_bytes += size;
+        return malloc(size);
+    }
+    else
+    {
+        free(ptr);
+        return NULL;
+    }
+}
+
+static bool run_parse(const char *json, size_t json_len)
+{
+    struct judo_error error = {0};
+    judo_value *root = NULL;
+    tree_bytes = 0;
+    if (judo_parse(json, json_len, &root, &error, NULL, counting_memfunc) != JUDO_RESULT_SUCCESS)
+    {
+        fprintf(stderr, "error: %s\n", error.description);
+        return false;
+    }
+    (void)judo_free(root, NULL, counting_memfunc);
+    return true;
+}
+#endif
+
+static int bench_spans(const char *json, size_t json_len)
+{
+    printf("  %-28s %10zu bits\n", "judo_size", sizeof(judo_size) * 8u);
+    printf("  %-28s %10zu bytes\n", "struct judo_span", sizeof(struct judo_span));
+    printf("  %-28s %10zu bytes\n", "struct judo_stream", sizeof(struct judo_stream));
+
+    const size_t count = repetitions(json_len);
+    double elapsed = measure(run_scan, json, json_len, count);
+    if (elapsed < 0.0)
+    {
+        return 1;
+    }
+    report("scan", json_len * count, elapsed);
+
+#if defined(JUDO_PARSER)
+    elapsed = measure(run_parse, json, json_len, count);
+    if (elapsed < 0.0)
+    {
+        return 1;
+    }
+    report("parse + free", json_len * count, elapsed);
+    printf("  %-28s %10zu bytes\n", "tree memory", tree_bytes);
+#endif
+
+    return 0;
+}
+
+#if defined(JUDO_HAVE_FLOATS)
+#if defined(JUDO_FLOAT_FLOAT)
+#define STRTONUM strtof
+#define STRTONUM_NAME "strtof"
+#elif defined(JUDO_FLOAT_DOUBLE)
+#define STRTONUM strtod
+#define STRTONUM_NAME "strtod"
+#else
+#define STRTONUM strtold
+#define STRTONUM_NAME "strtold"
+#endif
+
+// The number lexemes of the input, each copied and null terminated for the C library.
+static char *lexemes;
+static size_t *lexeme_offsets;
+static size_t lexeme_count;
+static judo_number *judo_results;
+static judo_number *libc_results;
+
+static bool run_numberify(const char *json, size_t json_len)
+{
+    (void)json;
+    (void)json_len;
+    for (size_t i = 0; i < lexeme_count; i++)
+    {
+        const char *lexeme = &lexemes[lexeme_offsets[i]];
+        const size_t length = lexeme_offsets[i + 1u] - lexeme_offsets[i] - 1u;
+        if (judo_numberify(lexeme, (judo_size)length, &judo_results[i]) != JUDO_RESULT_SUCCESS)
+        {
+            fprintf(stderr, "error: failed to convert '%s'\n", lexeme);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool run_strtonum(const char *json, size_t json_len)
+{
+    (void)json;
+    (void)json_len;
+    for (size_t i = 0; i < lexeme_count; i++)
+    {
+        libc_results[i] = STRTONUM(&lexemes[lexeme_offsets[i]], NULL);
+    }
+    return true;
+}
+
+// Copies the lexeme of every number of the input into the lexeme table.
+static bool collect_numbers(const char *json, size_t json_len)
+{
+    struct judo_stream stream = {0};
+    size_t capacity = 0;
+    size_t used = 0;
+
+    lexeme_offsets = malloc(sizeof(lexeme_offsets[0]));
+    if (lexeme_offsets == NULL)
+    {
+        return false;
+    }
+    lexeme_offsets[0] = 0;
+
+    for (;;)
+    {
+        if (judo_scan(&stream, json, json_len) != JUDO_RESULT_SUCCESS)
+        {
+            fprintf(stderr, "error: %s\n", stream.error);
+            return false;
+        }
+        if (stream.token == JUDO_TOKEN_EOF)
+        {
+            break;
+        }
+        if (stream.token != JUDO_TOKEN_NUMBER)
+        {
+            continue;
+        }
+
+        const size_t length = (size_t)stream.where.length;
+        if ((used + length + 1u) > capacity)
+        {
+            capacity = (capacity + length + 1u) * 2u;
+            char *grown = realloc(lexemes, capacity);
+            if (grown == NULL)
+            {
+                return false;
+            }
+            lexemes = grown;
+        }
+        size_t *offsets = realloc(lexeme_offsets, (lexeme_count + 2u) * sizeof(lexeme_offsets[0]));
+        if (offsets == NULL)
+        {
+            return false;
+        }
+        lexeme_offsets = offsets;
+
+        memcpy(&lexemes[used], &json[stream.where.offset], length);
+        lexemes[used + length] = '\0';
+        used += length + 1u;
+        lexeme_count += 1u;
+        lexeme_offsets[lexeme_count] = used;
+    }
+
+    judo_results = calloc(lexeme_count + 1u, sizeof(judo_results[0]));
+    libc_results = calloc(lexeme_count + 1u, sizeof(libc_results[0]));
+    return (judo_results != NULL) && (libc_results != NULL);
+}
+
+static int bench_numbers(const char *json, size_t json_len)
+{
+    static const struct
+    {
+        const char *label;
+        workload run;
+    } cases[] = {
+        {"judo_numberify", run_numberify},
+        {STRTONUM_NAME, run_strtonum},
+    };
+
+    if (!collect_numbers(json, json_len))
+    {
+        fprintf(stderr, "error: failed to collect the numbers\n");
+        return 1;
+    }
+
+    if (lexeme_count == 0u)
+    {
+        fprintf(stderr, "error: the input has no numbers\n");
+        return 1;
+    }
+
+    const size_t bytes = lexeme_offsets[lexeme_count] - lexeme_count;
+    const size_t count = repetitions(bytes);
+    printf("  %-28s %10zu\n", "numbers", lexeme_count);
+    printf("  %-28s %10zu bytes\n", "judo_number", sizeof(judo_number));
+    for (size_t i = 0; i < (sizeof(cases) / sizeof(cases[0])); i++)
+    {
+        const double elapsed = measure(cases[i].run, json, json_len, count);
+        if (elapsed < 0.0)
+        {
+            return 1;
+        }
+        report(cases[i].label, bytes * count, elapsed);
+        printf("  %-28s %10.1f ns/number\n", "", (elapsed * 1e9) / ((double)count * (double)lexeme_count));
+    }
+
+    // Both conversions are expected to be correctly rounded.
+    size_t mismatches = 0;
+    for (size_t i = 0; i < lexeme_count; i++)
+    {
+        const judo_number a = judo_results[i];
+        const judo_number b = libc_results[i];
+        if ((a != b) && !((a != a) && (b != b)))
+        {
+            if (mismatches < 10u)
+            {
+                fprintf(stderr, "mismatch: %s\n", &lexemes[lexeme_offsets[i]]);
+            }
+            mismatches += 1u;
+        }
+    }
+    printf("  %-28s %10zu\n", "mismatches", mismatches);
+
+    free(lexemes);
+    free(lexeme_offsets);
+    free(judo_results);
+    free(libc_results);
+    return (mismatches == 0u) ? 0 : 1;
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: %s utf8|spans|numbers input.json\n", argv[0]);
+        return 2;
+    }
+
+    size_t json_len = 0;
+    char *json = read_file(argv[2], &json_len);
+    if (json == NULL)
+    {
+        fprintf(stderr, "error: failed to read '%s'\n", argv[2]);
+        return 2;
+    }
+
+    int status = 2;
+    printf("%s: %s, %zu bytes\n", argv[1], argv[2], json_len);
+    if (strcmp(argv[1], "utf8") == 0)
+    {
+        status = bench_utf8(json, json_len);
+    }
+    else if (strcmp(argv[1], "spans") == 0)
+    {
+        status = bench_spans(json, json_len);
+    }
+#if defined(JUDO_HAVE_FLOATS)
+    else if (strcmp(argv[1], "numbers") == 0)
+    {
+        status = bench_numbers(json, json_len);
+    }
+#endif
+    else
+    {
+        fprintf(stderr, "error: unknown benchmark '%s'\n", argv[1]);
+    }
+
+    free(json);
+    return status;
+}
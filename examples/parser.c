@@ -55,7 +55,7 @@ void print_tree(const char *source, struct judo_value *value)
     case JUDO_TYPE_NUMBER:
     case JUDO_TYPE_STRING:
         span = judo_value2span(value);
-        printf("%.*s", span.length, &source[span.offset]);
+        printf("%.*s", (int)span.length, &source[span.offset]);
         break;
     // [cont...]
 //! [parser_process_traverse]
@@ -85,7 +85,7 @@ void print_tree(const char *source, struct judo_value *value)
         while (member != NULL)
         {
             span = judo_name2span(member);
-            printf("%.*s:", span.length, &source[span.offset]);
+            printf("%.*s:", (int)span.length, &source[span.offset]);
             print_tree(source, judo_membvalue(member));
             if (judo_membnext(member) != NULL)
             {
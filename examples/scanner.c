@@ -37,13 +37,13 @@ static void process_token(struct judo_stream stream, const char *json)
     case JUDO_TOKEN_OBJECT_BEGIN: puts("{push}"); break;
     case JUDO_TOKEN_OBJECT_END: puts("{pop}"); break;
     case JUDO_TOKEN_NUMBER:
-        printf("number: %.*s\n", stream.where.length, &json[stream.where.offset]);
+        printf("number: %.*s\n", (int)stream.where.length, &json[stream.where.offset]);
         break;
     case JUDO_TOKEN_STRING:
-        printf("string: %.*s\n", stream.where.length, &json[stream.where.offset]);
+        printf("string: %.*s\n", (int)stream.where.length, &json[stream.where.offset]);
         break;
     case JUDO_TOKEN_OBJECT_NAME:
-        printf("{name: %.*s}\n", stream.where.length, &json[stream.where.offset]);
+        printf("{name: %.*s}\n", (int)stream.where.length, &json[stream.where.offset]);
         break;
     default:
         break;
@@ -18,11 +18,9 @@
 
 #include "judo_config.h"
 #include <stdint.h>
+#include <stdbool.h>
 
-#if defined(JUDO_PARSER)
 #include <stddef.h>
-#include <stdbool.h>
-#endif
 
 #ifdef DOXYGEN
 #define JUDO_MAXDEPTH
@@ -31,6 +29,13 @@ typedef long double judo_number;
 
 #define JUDO_ERRMAX 36
 
+// Signed integer type for offsets and lengths in the JSON source text.
+#if defined(JUDO_WIDE_SPANS)
+typedef int64_t judo_size;
+#else
+typedef int32_t judo_size;
+#endif
+
 enum judo_result
 {
     JUDO_RESULT_SUCCESS,
@@ -43,6 +48,8 @@ enum judo_result
     JUDO_RESULT_INPUT_TOO_LARGE,
     JUDO_RESULT_OUT_OF_MEMORY,
     JUDO_RESULT_MALFUNCTION,
+    JUDO_RESULT_NEED_MORE,
+    JUDO_RESULT_NOT_FOUND,
 };
 
 // Judo semantic tokens mark a point of interests when parsing the JSON stream.
@@ -63,29 +70,81 @@ enum judo_token
     JUDO_TOKEN_EOF
 };
 
+// Classification of a number token.
+enum judo_numtype
+{
+    JUDO_NUMTYPE_INVALID, // The token or value isn't a number.
+    JUDO_NUMTYPE_INTEGER, // Digits without a fraction or exponent, e.g. '-12'.
+    JUDO_NUMTYPE_DECIMAL, // A number with a fraction or exponent, e.g. '1.5e3'.
+    JUDO_NUMTYPE_HEX, // A JSON5 hexadecimal number, e.g. '0xFF'.
+    JUDO_NUMTYPE_SPECIAL, // JSON5 'NaN' or 'Infinity'.
+};
+
 // A range of UTF-8 code units in the JSON source text.
 struct judo_span
 {
-    int32_t offset;
-    int32_t length;
+    judo_size offset;
+    judo_size length;
 };
 
 // Field names beginning with "s_" are private to the scanner implementation and must not be accessed.
 struct judo_stream
 {
 #ifndef DOXYGEN
-    int32_t s_at;
+    judo_size s_at;
+    judo_size s_length;
+    judo_size s_string;
+    judo_size s_resume;
 #endif
     struct judo_span where;
     enum judo_token token;
+    bool escaped; // True if the string or object name has escape sequences.
+    enum judo_numtype numtype; // Classification of a number.
+    judo_size digits; // Number of digits in a number excluding its exponent.
 #ifndef DOXYGEN
-    int8_t s_stack;
-    int8_t s_state[JUDO_MAXDEPTH];
+    uint8_t *s_spill;
+    int32_t s_depth;
+    int32_t s_stack;
+    uint8_t s_flags;
+    int8_t s_state;
+    uint8_t s_kinds[(JUDO_MAXDEPTH + 7) / 8];
 #endif
     char error[JUDO_ERRMAX];
 };
 
+// A semantic token and its location in the JSON source text.
+struct judo_item
+{
+    enum judo_token token;
+    struct judo_span where;
+    bool escaped;
+    enum judo_numtype numtype;
+    judo_size digits;
+};
+
+// A value in the JSON source text located on demand. The stream is positioned at the first token
+// of the value and 'name' is the lexeme of its member name if it's the value of an object member.
+// Field names beginning with "s_" are private to the cursor implementation and must not be accessed.
+struct judo_cursor
+{
+    struct judo_stream stream;
+    struct judo_span name;
+#ifndef DOXYGEN
+    const char *s_source;
+    judo_size s_length;
+#endif
+};
+
 #if defined(JUDO_PARSER)
+// Flags for judo_parseopt().
+#if defined(JUDO_WITH_SIZED_PARSING)
+#define JUDO_PARSE_SIZED 0x1u // Allocate the tree in a single block like judo_parsesized().
+#endif
+#define JUDO_PARSE_INDEXARRAYS 0x2u // Build an element vector for each array so judo_at() is constant-time.
+#define JUDO_PARSE_PREVALIDATE 0x4u // Validate the UTF-8 encoding of the input upfront with judo_prevalidate().
+#define JUDO_PARSE_HASHOBJECTS 0x8u // Build a hash table for each large object so judo_get() is constant-time.
+#define JUDO_PARSE_CONVERTNUMBERS 0x10u // Convert each number while parsing so judo_tointeger() and judo_tonumber() needn't.
+
 typedef void *(*judo_memfunc)(void *user_data, void *ptr, size_t size);
 
 typedef struct judo_value judo_value;
@@ -107,41 +166,196 @@ struct judo_error
     struct judo_span where;
     char description[JUDO_ERRMAX];
 };
+
+// Field names beginning with "s_" are private to the arena implementation and must not be accessed.
+struct judo_arena
+{
+#ifndef DOXYGEN
+    void *s_slab;
+    size_t s_used;
+    size_t s_capacity;
+    void *s_udata;
+    judo_memfunc s_memfunc;
+#endif
+};
+
+// Field names beginning with "s_" are private to the tape implementation and must not be accessed.
+struct judo_tape
+{
+#ifndef DOXYGEN
+    void *s_entries;
+    judo_size s_count;
+    judo_size s_capacity;
+#endif
+};
+
+// Field names beginning with "s_" are private to the projection implementation and must not be accessed.
+struct judo_projection
+{
+#ifndef DOXYGEN
+    void *s_steps;
+    char *s_names;
+    size_t s_size;
+    int32_t s_count;
+    int32_t s_capacity;
+#endif
+};
 #endif
 
 // This is conceptually like a generator function or coroutine in that it returns values on demand.
 // Pass '-1' as the input length if the input is null terminated.
-enum judo_result judo_scan(struct judo_stream *stream, const char *source, int32_t length);
+enum judo_result judo_scan(struct judo_stream *stream, const char *source, judo_size length);
+
+// Like judo_scan() but scans up to 'capacity' tokens per call. Scanning stops early at
+// the end of the input or if an error occurs.
+enum judo_result judo_scan_many(struct judo_stream *stream, const char *source, judo_size length, struct judo_item *items, int32_t capacity, int32_t *count);
+
+// Consumes the array or object whose opening bracket is the current token of the stream. The stream
+// is left at its closing bracket so the next call to judo_scan() returns the token after it. With
+// JUDO_SKIP_RELAXED, the tokens in-between are passed over by counting brackets without validation.
+#define JUDO_SKIP_RELAXED 0x1u
+enum judo_result judo_scan_skip(struct judo_stream *stream, const char *source, judo_size length, uint32_t flags);
+
+// Scans a window of the input when it's received in chunks. The window begins at the
+// absolute 'offset' of the input and must include every byte from the offset where the
+// scanner left off. Pass 'final' as true once the window extends to the end of the input.
+// A string split across windows resumes where the previous window left off, but any other
+// token is scanned again from its beginning, so avoid windows much smaller than a token.
+enum judo_result judo_scan_push(struct judo_stream *stream, const char *window, judo_size offset, judo_size length, bool final);
 
-enum judo_result judo_stringify(const char *lexeme, int32_t length, char *buf, int32_t *buflen);
+// Verifies the input is well-formed UTF-8 so judo_scan() needn't decode each character.
+// Call this before the first call to judo_scan() and pass it the same input.
+enum judo_result judo_prevalidate(struct judo_stream *stream, const char *source, judo_size length);
+
+// Permits the scanner to nest up to 'depth' levels rather than JUDO_MAXDEPTH. The state of the
+// first JUDO_MAXDEPTH levels is kept in the stream and the state of deeper levels, one bit per
+// level, in 'stack' which must have room for judo_stacksize() bytes. This can be called while scanning to move
+// to a larger stack in which case the state is copied from the previous one.
+enum judo_result judo_setdepth(struct judo_stream *stream, void *stack, int32_t depth);
+size_t judo_stacksize(int32_t depth);
+
+// Cursors scan the input on demand rather than building a tree. They're positioned at the first
+// token of a value and skip over the values between the cursor and the requested element or member.
+enum judo_result judo_cursor_init(struct judo_cursor *cursor, const char *source, judo_size length);
+enum judo_result judo_cursor_get(const struct judo_cursor *object, const char *key, judo_size keylen, struct judo_cursor *value);
+enum judo_result judo_cursor_at(const struct judo_cursor *container, judo_size index, struct judo_cursor *value);
+
+// Moves the cursor past its value to the next element or member of the enclosing container.
+// Arrays and objects which are skipped are matched by their brackets without being validated.
+enum judo_result judo_cursor_skip(struct judo_cursor *cursor);
+
+enum judo_result judo_stringify(const char *lexeme, judo_size length, char *buf, judo_size *buflen);
+
+// Like judo_stringify() but decodes the lexeme into itself, overwriting it. The decoded
+// string begins at the first byte of the lexeme and its length is written to 'buflen'.
+enum judo_result judo_stringify_inplace(char *lexeme, judo_size length, judo_size *buflen);
 
 #if defined(JUDO_HAVE_FLOATS)
-enum judo_result judo_numberify(const char *lexeme, int32_t length, judo_number *number);
+enum judo_result judo_numberify(const char *lexeme, judo_size length, judo_number *number);
 #endif
 
+// Converts the lexeme of a number to an integer. Numbers with a fractional part and numbers
+// outside the range of the integer type are rejected with JUDO_RESULT_OUT_OF_RANGE.
+enum judo_result judo_integerify(const char *lexeme, judo_size length, int64_t *integer);
+enum judo_result judo_uintegerify(const char *lexeme, judo_size length, uint64_t *integer);
+
 #if defined(JUDO_PARSER)
 // Parses the input into an in-memory tree. Pass '-1' as the input length
 // if the input is null terminated.
-enum judo_result judo_parse(const char *source, int32_t length, judo_value **root, struct judo_error *error, void *udata, judo_memfunc memfunc);
+enum judo_result judo_parse(const char *source, judo_size length, judo_value **root, struct judo_error *error, void *udata, judo_memfunc memfunc);
+
+#if defined(JUDO_WITH_SIZED_PARSING)
+// Like judo_parse() but scans the input twice: first to compute the size of the tree
+// and then to build it in a single allocation.
+enum judo_result judo_parsesized(const char *source, judo_size length, judo_value **root, struct judo_error *error, void *udata, judo_memfunc memfunc);
+#endif
+
+// Like judo_parse() but accepts a bitwise OR of JUDO_PARSE_* flags.
+enum judo_result judo_parseopt(const char *source, judo_size length, judo_value **root, struct judo_error *error, void *udata, judo_memfunc memfunc, uint32_t flags);
+
+// Like judo_parseopt() but permits nesting up to 'depth' levels rather than JUDO_MAXDEPTH.
+// Levels beyond JUDO_MAXDEPTH are kept in memory from 'memfunc' as the document nests deeper.
+enum judo_result judo_parsedepth(const char *source, judo_size length, judo_value **root, struct judo_error *error, void *udata, judo_memfunc memfunc, uint32_t flags, int32_t depth);
+
+// Compiles paths, such as "/user/id" and "/items/*/price", for judo_parseproj(). Paths are
+// JSON Pointers where the segment '*' matches every member or element. The empty path selects
+// the whole document.
+enum judo_result judo_projinit(struct judo_projection *projection, const char *const *paths, int32_t count, void *udata, judo_memfunc memfunc);
+enum judo_result judo_projfree(struct judo_projection *projection, void *udata, judo_memfunc memfunc);
+
+// Like judo_parsedepth() but only builds the values selected by the projection, along with the
+// arrays and objects enclosing them. Everything else is skipped and validated but not allocated.
+enum judo_result judo_parseproj(const char *source, judo_size length, judo_value **root, struct judo_error *error, void *udata, judo_memfunc memfunc, uint32_t flags, int32_t depth, const struct judo_projection *projection);
 
 // Pass the root value returned from judo_parse() to free the entire tree.
 enum judo_result judo_free(judo_value *root, void *udata, judo_memfunc memfunc);
 
+// Prepares an arena which obtains large slabs of memory from 'memfunc'. Pass judo_arenafunc()
+// as the memory function and the arena as the user data pointer to judo_parse() to allocate
+// the tree from the arena. The tree is released all at once by resetting or freeing the arena.
+enum judo_result judo_arenainit(struct judo_arena *arena, void *udata, judo_memfunc memfunc);
+void *judo_arenafunc(void *user_data, void *ptr, size_t size);
+enum judo_result judo_arenareset(struct judo_arena *arena);
+enum judo_result judo_arenafree(struct judo_arena *arena);
+
 enum judo_type judo_gettype(const judo_value *value);
 
+// Returns the classification of a number value and, if 'digits' isn't null, writes the
+// number of digits excluding its exponent. JUDO_NUMTYPE_INVALID is returned for non-numbers.
+enum judo_numtype judo_getnumtype(const judo_value *value, judo_size *digits);
+
 bool judo_tobool(judo_value *value);
 
-int32_t judo_len(judo_value *value);
+// Converts a number value like judo_integerify() and judo_numberify(). If the tree was parsed
+// with JUDO_PARSE_CONVERTNUMBERS, then the value is loaded from the tree and 'source' may be
+// null. Otherwise, the source text the tree was parsed from is required to convert its lexeme.
+enum judo_result judo_tointeger(const judo_value *value, const char *source, int64_t *integer);
+#if defined(JUDO_HAVE_FLOATS)
+enum judo_result judo_tonumber(const judo_value *value, const char *source, judo_number *number);
+#endif
+
+judo_size judo_len(judo_value *value);
 
 judo_value *judo_first(judo_value *value);
 judo_value *judo_next(judo_value *value);
+judo_value *judo_at(judo_value *value, judo_size index);
 
 judo_member *judo_membfirst(judo_value *value);
 judo_member *judo_membnext(judo_member *member);
 judo_value *judo_membvalue(judo_member *member);
 
+// Retrieves the value of the first member of an object whose unescaped name is 'key'. The
+// source text the tree was parsed from is required to compare names. Pass '-1' as the key
+// length if the key is null terminated.
+judo_value *judo_get(judo_value *value, const char *source, const char *key, judo_size keylen);
+
 struct judo_span judo_name2span(const judo_member *member);
 struct judo_span judo_value2span(const judo_value *value);
+
+// Returns a pointer to the content of a string value in the source text, excluding its quotes, if
+// it has no escape sequences. Otherwise null is returned and judo_stringify() must be used.
+const char *judo_strview(const judo_value *value, const char *source, judo_size *length);
+
+// Parses the input into a tape: a single array of entries in document order. Entries are
+// referenced by their index where the root value is at index zero. Functions which return
+// an index return '-1' if there is no such entry.
+enum judo_result judo_parsetape(const char *source, judo_size length, struct judo_tape *tape, struct judo_error *error, void *udata, judo_memfunc memfunc);
+// Like judo_parsetape() but permits nesting up to 'depth' levels rather than JUDO_MAXDEPTH.
+enum judo_result judo_parsetapedepth(const char *source, judo_size length, struct judo_tape *tape, struct judo_error *error, void *udata, judo_memfunc memfunc, int32_t depth);
+enum judo_result judo_freetape(struct judo_tape *tape, void *udata, judo_memfunc memfunc);
+
+enum judo_type judo_tapetype(const struct judo_tape *tape, judo_size at);
+bool judo_tapebool(const struct judo_tape *tape, judo_size at);
+judo_size judo_tapelen(const struct judo_tape *tape, judo_size at);
+
+// The first element of an array or the first member of an object.
+judo_size judo_tapefirst(const struct judo_tape *tape, judo_size at);
+// The next element or member. This skips the subtree of the current entry by jumping past its end.
+judo_size judo_tapenext(const struct judo_tape *tape, judo_size at);
+judo_size judo_tapevalue(const struct judo_tape *tape, judo_size member);
+
+// The lexeme of a value or member name.
+struct judo_span judo_tapespan(const struct judo_tape *tape, judo_size at);
 #endif
 
 #endif
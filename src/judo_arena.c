@@ -0,0 +1,245 @@
+/*
+ *  Judo - Embeddable JSON and JSON5 parser.
+ *  Copyright (c) 2025 Railgun Labs, LLC
+ *
+ *  This software is dual-licensed: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3 as
+ *  published by the Free Software Foundation. For the terms of this
+ *  license, see <https://www.gnu.org/licenses/>.
+ *
+ *  Alternatively, you can license this software under a proprietary
+ *  license, as set out in <https://railgunlabs.com/judo/license/>.
+ */
+
+// This file implements a region-based memory allocator for the parser. Memory
+// is obtained from the user memory function in large slabs and handed out by
+// bumping an offset. Individual allocations are never freed; instead the whole
+// region is released or reset at once. This replaces one allocator round trip
+// per tree node with one per slab.
+
+#include "judo.h"
+#include "judo_utils.h"
+
+#if defined(JUDO_PARSER)
+#include <string.h>
+#include <assert.h>
+
+// Number of bytes requested from the user memory function for each slab.
+#ifndef JUDO_ARENA_SLAB_SIZE
+#define JUDO_ARENA_SLAB_SIZE ((size_t)64 * 1024)
+#endif
+
+// Every allocation is aligned to this boundary which suffices for the tree nodes.
+#define ARENA_ALIGNMENT ((size_t)8)
+
+// Strictest alignment judo_arenaalign() can provide. The data of each slab begins at this boundary.
+#define SLAB_ALIGNMENT ((size_t)16)
+
+// Slabs are linked together through a header at the beginning of each slab.
+struct slab
+{
+    struct slab *prev;
+    size_t size;
+};
+
+static size_t align_to(size_t size, size_t alignment)
+{
+    return (size + (alignment - 1u)) & ~(alignment - 1u);
+}
+
+static size_t align_up(size_t size)
+{
+    return align_to(size, ARENA_ALIGNMENT);
+}
+
+static uint8_t *slab_data(struct slab *slab)
+{
+    return &((uint8_t *)slab)[align_to(sizeof(struct slab), SLAB_ALIGNMENT)]; // cppcheck-suppress misra-c2012-11.3 ; Cast to byte pointer.
+}
+
+static struct slab *new_slab(const struct judo_arena *arena, size_t payload)
+{
+    const size_t header = align_to(sizeof(struct slab), SLAB_ALIGNMENT);
+    struct slab *slab = NULL;
+
+    // The slab header is added to the payload so guard against wrap around.
+    if (payload <= (SIZE_MAX - header))
+    {
+        const size_t size = header + payload;
+        slab = arena->s_memfunc(arena->s_udata, NULL, size); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+        if (slab != NULL)
+        {
+            slab->prev = NULL;
+            slab->size = size;
+        }
+    }
+
+    return slab;
+}
+
+static void free_slabs(const struct judo_arena *arena, struct slab *slab)
+{
+    struct slab *next = slab;
+    while (next != NULL)
+    {
+        struct slab *prev = next->prev;
+        (void)arena->s_memfunc(arena->s_udata, next, next->size);
+        next = prev;
+    }
+}
+
+enum judo_result judo_arenainit(struct judo_arena *arena, void *udata, judo_memfunc memfunc) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+
+    if (arena == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (memfunc == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        (void)memset(arena, 0, sizeof(arena[0]));
+        arena->s_udata = udata;
+        arena->s_memfunc = memfunc;
+    }
+
+    return result;
+}
+
+// Allocates 'size' bytes from the arena at an offset within its slab which is a multiple of 'alignment'.
+static void *arena_alloc(struct judo_arena *arena, size_t size, size_t alignment)
+{
+    void *block = NULL;
+    struct slab *current = arena->s_slab; // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+    const size_t used = align_to(arena->s_used, alignment);
+
+    // Rounding the size up to the alignment must not wrap around.
+    const bool representable = (size <= (SIZE_MAX - (ARENA_ALIGNMENT - 1u)));
+    const size_t needed = representable ? align_up(size) : 0u;
+
+    if (!representable)
+    {
+        // The request can't be satisfied.
+    }
+    else if ((current != NULL) && (used <= arena->s_capacity) && (needed <= (arena->s_capacity - used)))
+    {
+        block = &slab_data(current)[used];
+        arena->s_used = used + needed;
+    }
+    else if (needed > (JUDO_ARENA_SLAB_SIZE / 4u))
+    {
+        // Large allocations receive a dedicated slab which is linked behind the
+        // current slab so the remaining space in the current slab isn't wasted.
+        struct slab *slab = new_slab(arena, needed);
+        if (slab != NULL)
+        {
+            if (current == NULL)
+            {
+                arena->s_slab = slab;
+                arena->s_used = needed;
+                arena->s_capacity = needed;
+            }
+            else
+            {
+                slab->prev = current->prev;
+                current->prev = slab;
+            }
+            block = slab_data(slab);
+        }
+    }
+    else
+    {
+        struct slab *slab = new_slab(arena, JUDO_ARENA_SLAB_SIZE);
+        if (slab != NULL)
+        {
+            slab->prev = current;
+            arena->s_slab = slab;
+            arena->s_used = needed;
+            arena->s_capacity = JUDO_ARENA_SLAB_SIZE;
+            block = slab_data(slab);
+        }
+    }
+
+    return block;
+}
+
+void *judo_arenafunc(void *user_data, void *ptr, size_t size) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    struct judo_arena *arena = user_data; // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+    void *block = NULL;
+
+    assert(arena != NULL); // LCOV_EXCL_BR_LINE
+    assert(arena->s_memfunc != NULL); // LCOV_EXCL_BR_LINE
+
+    // Individual allocations are reclaimed when the arena is reset or freed.
+    if (ptr == NULL)
+    {
+        block = arena_alloc(arena, size, ARENA_ALIGNMENT);
+    }
+
+    return block;
+}
+
+void *judo_arenaalign(struct judo_arena *arena, size_t size, size_t alignment)
+{
+    assert(arena != NULL); // LCOV_EXCL_BR_LINE
+    assert((alignment <= SLAB_ALIGNMENT) && ((alignment & (alignment - 1u)) == 0u)); // LCOV_EXCL_BR_LINE
+    return arena_alloc(arena, size, (alignment > ARENA_ALIGNMENT) ? alignment : ARENA_ALIGNMENT);
+}
+
+enum judo_result judo_arenareset(struct judo_arena *arena) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+
+    if (arena == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (arena->s_slab == NULL)
+    {
+        // No action.
+    }
+    else if (arena->s_capacity != JUDO_ARENA_SLAB_SIZE)
+    {
+        // The current slab is a dedicated slab from a large first allocation.
+        // Retaining it would pin an oversized block for the lifetime of the arena.
+        free_slabs(arena, arena->s_slab); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+        arena->s_slab = NULL;
+        arena->s_used = 0;
+        arena->s_capacity = 0;
+    }
+    else
+    {
+        // Keep the most recent slab so the next document needn't allocate one.
+        struct slab *current = arena->s_slab; // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+        free_slabs(arena, current->prev);
+        current->prev = NULL;
+        arena->s_used = 0;
+    }
+
+    return result;
+}
+
+enum judo_result judo_arenafree(struct judo_arena *arena) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+
+    if (arena == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        free_slabs(arena, arena->s_slab); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+        arena->s_slab = NULL;
+        arena->s_used = 0;
+        arena->s_capacity = 0;
+    }
+
+    return result;
+}
+#endif
@@ -0,0 +1,183 @@
+/*
+ *  Judo - Embeddable JSON and JSON5 parser.
+ *  Copyright (c) 2025 Railgun Labs, LLC
+ *
+ *  This software is dual-licensed: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3 as
+ *  published by the Free Software Foundation. For the terms of this
+ *  license, see <https://www.gnu.org/licenses/>.
+ *
+ *  Alternatively, you can license this software under a proprietary
+ *  license, as set out in <https://railgunlabs.com/judo/license/>.
+ */
+
+// This file implements on-demand access to a document without building a tree. A cursor is a
+// copy of the scanner positioned at the first token of a value. Looking up an element or member
+// copies the cursor of the container and scans forward only as far as the requested value, and
+// the values in-between are passed over with judo_scan_skip(). Arrays and objects which are
+// skipped are only bracket matched, not validated, since the caller never reads them. Since the
+// scanner is copied rather than shared, cursors are independent of one another and nothing is allocated.
+
+#include "judo.h"
+#include "judo_utils.h"
+#include <string.h>
+#include <stdint.h>
+
+// Checks if the token is the first token of a value.
+static bool is_value(enum judo_token token)
+{
+    bool is;
+    switch (token)
+    {
+    case JUDO_TOKEN_NULL:
+    case JUDO_TOKEN_TRUE:
+    case JUDO_TOKEN_FALSE:
+    case JUDO_TOKEN_NUMBER:
+    case JUDO_TOKEN_STRING:
+    case JUDO_TOKEN_ARRAY_BEGIN:
+    case JUDO_TOKEN_OBJECT_BEGIN:
+        is = true;
+        break;
+
+    default:
+        is = false;
+        break;
+    }
+    return is;
+}
+
+static enum judo_result next_token(struct judo_cursor *cursor)
+{
+    return judo_scan(&cursor->stream, cursor->s_source, cursor->s_length);
+}
+
+// Scans the first token of the value that follows the one the cursor just finished. If the value
+// is the value of an object member, then the member name is remembered. If there is no such value,
+// then the cursor is left at the closing bracket of the enclosing container or the end of input.
+static enum judo_result next_value(struct judo_cursor *cursor)
+{
+    enum judo_result result = next_token(cursor);
+    cursor->name = (struct judo_span){0, 0};
+    if (result == JUDO_RESULT_SUCCESS)
+    {
+        if (cursor->stream.token == JUDO_TOKEN_OBJECT_NAME)
+        {
+            cursor->name = cursor->stream.where;
+            result = next_token(cursor);
+        }
+        else if (!is_value(cursor->stream.token))
+        {
+            result = JUDO_RESULT_NOT_FOUND;
+        }
+        else
+        {
+            // No action.
+        }
+    }
+    return result;
+}
+
+enum judo_result judo_cursor_init(struct judo_cursor *cursor, const char *source, judo_size length) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result;
+
+    if (cursor == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (source == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        (void)memset(cursor, 0, sizeof(cursor[0]));
+        cursor->s_source = source;
+        cursor->s_length = length;
+        result = next_token(cursor);
+    }
+
+    return result;
+}
+
+enum judo_result judo_cursor_get(const struct judo_cursor *object, const char *key, judo_size keylen, struct judo_cursor *value) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result;
+
+    if ((object == NULL) || (value == NULL) || (key == NULL))
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (object->stream.token != JUDO_TOKEN_OBJECT_BEGIN)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        // The object cursor is copied so that it can be reused and so that it can be the output.
+        const judo_size length = (keylen < 0) ? (judo_size)strlen(key) : keylen;
+        struct judo_cursor cursor = *object;
+        result = next_value(&cursor);
+        while ((result == JUDO_RESULT_SUCCESS) && !judo_nameeq(&cursor.s_source[cursor.name.offset], cursor.name.length, key, length))
+        {
+            result = judo_cursor_skip(&cursor);
+        }
+        *value = cursor;
+    }
+
+    return result;
+}
+
+enum judo_result judo_cursor_at(const struct judo_cursor *container, judo_size index, struct judo_cursor *value) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result;
+
+    if ((container == NULL) || (value == NULL) || (index < 0))
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if ((container->stream.token != JUDO_TOKEN_ARRAY_BEGIN) && (container->stream.token != JUDO_TOKEN_OBJECT_BEGIN))
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        struct judo_cursor cursor = *container;
+        result = next_value(&cursor);
+        for (judo_size i = 0; (result == JUDO_RESULT_SUCCESS) && (i < index); i++)
+        {
+            result = judo_cursor_skip(&cursor);
+        }
+        *value = cursor;
+    }
+
+    return result;
+}
+
+enum judo_result judo_cursor_skip(struct judo_cursor *cursor) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+
+    if (cursor == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (!is_value(cursor->stream.token))
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        if ((cursor->stream.token == JUDO_TOKEN_ARRAY_BEGIN) || (cursor->stream.token == JUDO_TOKEN_OBJECT_BEGIN))
+        {
+            result = judo_scan_skip(&cursor->stream, cursor->s_source, cursor->s_length, JUDO_SKIP_RELAXED);
+        }
+
+        if (result == JUDO_RESULT_SUCCESS)
+        {
+            result = next_value(cursor);
+        }
+    }
+
+    return result;
+}
@@ -92,12 +92,12 @@ static int32_t decode_utf8(const char *string, uint32_t *scalar)
 // requires implementing the Unicode grapheme cluster break algorithm.
 // An implementation of this algorithm is available in the Unicorn library
 // available here: <https://railgunlabs.com/unicorn/>.
-static void compulate_source_location(const char *input, int32_t input_length, int32_t location, int *line, int *column)
+static void compulate_source_location(const char *input, judo_size input_length, judo_size location, int *line, int *column)
 {
     *line = 1;
     *column = 1;
 
-    int32_t at = 0;
+    judo_size at = 0;
     while (at < location)
     {
         if ((at < location + 1) && (at < input_length - 2))
@@ -131,6 +131,13 @@ static void compulate_source_location(const char *input, int32_t input_length, i
     }
 }
 
+// Lexemes are written with fwrite() rather than printf() because the precision
+// of the "%.*s" format specifier is an int which is narrower than a span.
+static void print_span(const char *source, struct judo_span where)
+{
+    (void)fwrite(&source[where.offset], 1, (size_t)where.length, stdout);
+}
+
 static void print_tree(struct judo_value *value, const char *source, const struct program_options *options)
 {
     struct judo_span where = {0};
@@ -141,7 +148,7 @@ static void print_tree(struct judo_value *value, const char *source, const struc
     case JUDO_TYPE_NUMBER:
     case JUDO_TYPE_STRING:
         where = judo_value2span(value);
-        printf("%.*s", where.length, &source[where.offset]);
+        print_span(source, where);
         break;
 
     case JUDO_TYPE_ARRAY:
@@ -162,7 +169,8 @@ static void print_tree(struct judo_value *value, const char *source, const struc
         for (struct judo_member *member = judo_membfirst(value); member != NULL; member = judo_membnext(member))
         {
             where = judo_name2span(member);
-            printf("%.*s:", where.length, &source[where.offset]);
+            print_span(source, where);
+            putchar(':');
             print_tree(judo_membvalue(member), source, options);
             if (judo_membnext(member) != NULL)
             {
@@ -207,7 +215,7 @@ static void pretty_print_tree(struct judo_value *value, const char *source, int
     case JUDO_TYPE_NUMBER:
     case JUDO_TYPE_STRING:
         where = judo_value2span(value);
-        printf("%.*s", where.length, &source[where.offset]);
+        print_span(source, where);
         break;
 
     case JUDO_TYPE_ARRAY:
@@ -247,7 +255,8 @@ static void pretty_print_tree(struct judo_value *value, const char *source, int
                 pretty_print_indent(depth + 1, options);
 
                 where = judo_name2span(member);
-                printf("%.*s: ", where.length, &source[where.offset]);
+                print_span(source, where);
+                printf(": ");
 
                 pretty_print_tree(judo_membvalue(member), source, depth + 1, options);
 
@@ -291,11 +300,16 @@ static void judo_main(const struct program_options *options)
         exit(2);
     }
 
+    // The tree is allocated from an arena so it's released all at once.
+    struct judo_arena arena;
+    (void)judo_arenainit(&arena, NULL, memfunc);
+
     struct judo_error error = {0};
     struct judo_value *root;
-    const enum judo_result result = judo_parse(dynbuf, dynbuf_length, &root, &error, NULL, memfunc);
+    const enum judo_result result = judo_parse(dynbuf, (judo_size)dynbuf_length, &root, &error, &arena, judo_arenafunc);
     if (result != JUDO_RESULT_SUCCESS)
     {
+        (void)judo_arenafree(&arena);
         if (result == JUDO_RESULT_OUT_OF_MEMORY)
         {
             fprintf(stderr, "error: memory allocation failed\n");
@@ -304,7 +318,7 @@ static void judo_main(const struct program_options *options)
         }
 
         int line, column;
-        compulate_source_location(dynbuf, (int32_t)dynbuf_length, error.where.offset, &line, &column);
+        compulate_source_location(dynbuf, (judo_size)dynbuf_length, error.where.offset, &line, &column);
         fprintf(stderr, "stdin:%d:%d: error: %s\n", line, column, error.description);
         free(dynbuf);
         exit(1);
@@ -323,7 +337,7 @@ static void judo_main(const struct program_options *options)
     }
 
     free(dynbuf);
-    judo_free(root, NULL, memfunc);
+    (void)judo_arenafree(&arena);
 }
 
 int main(int argc, char *argv[])
@@ -368,6 +382,11 @@ int main(int argc, char *argv[])
 #endif
 
             printf("  Maximum structure depth: %d\n", JUDO_MAXDEPTH);
+#if defined(JUDO_WIDE_SPANS)
+            puts("  Source offsets: 64-bit");
+#else
+            puts("  Source offsets: 32-bit");
+#endif
 
             puts("");
             puts("Options:");
@@ -18,16 +18,71 @@
 // reserving larger structures exclusively for JSON types that require it.
 
 #include "judo.h"
+#include "judo_utils.h"
 
 #if defined(JUDO_PARSER)
 #include <string.h>
 #include <assert.h>
+#if defined(JUDO_HAVE_FLOATS)
+#include <float.h>
+#endif
+
+// Number of tokens scanned at a time by the parser.
+#define SCAN_BATCH_SIZE 32
+
+// Objects with at least this many members receive a hash table when parsed with JUDO_PARSE_HASHOBJECTS.
+// Smaller objects are searched linearly which is as fast and saves the memory.
+#ifndef JUDO_HASH_THRESHOLD
+#define JUDO_HASH_THRESHOLD 8
+#endif
+
+// Number of bits in the significand of judo_number.
+#if defined(JUDO_FLOAT_FLOAT)
+#define NUMBER_MANT_DIG FLT_MANT_DIG
+#elif defined(JUDO_FLOAT_DOUBLE)
+#define NUMBER_MANT_DIG DBL_MANT_DIG
+#elif defined(JUDO_FLOAT_LONGDOUBLE)
+#define NUMBER_MANT_DIG LDBL_MANT_DIG
+#endif
+
+// Allocations from a tree allocated in a single block are aligned to this boundary.
+#define BLOCK_ALIGNMENT ((size_t)8)
+
+// Converted numbers are aligned to this boundary instead since judo_number may require a stricter
+// alignment than the other nodes, like long double does on x86-64. It's computed with offsetof()
+// because _Alignof() requires C11.
+#if defined(JUDO_HAVE_FLOATS)
+struct number_alignment
+{
+    char byte;
+    judo_number number;
+};
+#define NUMBER_ALIGNMENT offsetof(struct number_alignment, number)
+#define CONVERTED_ALIGNMENT ((NUMBER_ALIGNMENT > BLOCK_ALIGNMENT) ? NUMBER_ALIGNMENT : BLOCK_ALIGNMENT)
+#else
+#define CONVERTED_ALIGNMENT BLOCK_ALIGNMENT
+#endif
+
+// Parameters for the 32-bit FNV-1a hash function.
+#define FNV_OFFSET_BASIS 0x811C9DC5u
+#define FNV_PRIME 0x01000193u
+
+// Flags for JSON values.
+#if defined(JUDO_WITH_SIZED_PARSING)
+#define VALUE_BLOCK 0x01u // The value is the root of a tree allocated in a single block.
+#endif
+#define VALUE_ESCAPED 0x02u // The string value has escape sequences.
+#define VALUE_CONVERTED 0x04u // The number value was converted while parsing and is a 'struct converted'.
+#define VALUE_INTEGER 0x08u // The converted number has an integer.
+#define VALUE_REAL 0x10u // The converted number has a floating-point number.
+#define VALUE_OVERFLOW 0x20u // The floating-point number of the converted number overflowed.
 
 struct judo_value
 {
     judo_value *next;
     struct judo_span where;
     uint8_t type;
+    uint8_t flags;
 };
 
 struct judo_member
@@ -43,25 +98,71 @@ struct boolean
     uint8_t value;
 };
 
+struct number
+{
+    judo_value descriptor; // Must be the first field in-memory for casting.
+    judo_size digits; // Number of digits excluding the exponent.
+    uint8_t numtype;
+};
+
+// Number values parsed with JUDO_PARSE_CONVERTNUMBERS also store their converted value. The
+// flags of the value indicate whether the integer, the floating-point number, or both are set.
+struct converted
+{
+    struct number number; // Must be the first field in-memory for casting.
+    int64_t integer;
+#if defined(JUDO_HAVE_FLOATS)
+    judo_number real;
+#endif
+};
+
 struct array
 {
     judo_value descriptor; // Must be the first field in-memory for casting.
     judo_value *next;
-    int32_t length;
+    judo_value **elements; // Element pointers for constant-time indexing (or null if not indexed).
+    judo_size length;
+};
+
+// Slot of the open-addressing hash table which maps the unescaped names of an object's members to the members.
+struct slot
+{
+    judo_member *member; // Null if the slot is unoccupied.
+    uint32_t hash;
 };
 
 struct object
 {
     judo_value descriptor; // Must be the first field in-memory for casting.
     judo_member *members;
-    int32_t size;
+    struct slot *slots; // Hash table of the members (or null if not hashed).
+    judo_size size;
+    uint32_t capacity; // Number of slots in the hash table which is always a power of two.
+};
+
+#if defined(JUDO_WITH_SIZED_PARSING)
+// Trees parsed by judo_parsesized() are allocated in a single block which begins with this header.
+// The header is followed immediately by the root value.
+struct block
+{
+    size_t size;
+    judo_value *root;
 };
+#endif
 
 struct parse_stack
 {
     judo_value *collection; // The current array or object being parsed (or null if neither are being parsed).
     judo_value *elements_tail; // Last array element of the current array being parsed.
     judo_member *members_tail; // Last object member of the current object being parsed.
+#if defined(JUDO_WITH_SIZED_PARSING)
+    judo_size count; // Number of elements or members counted when measuring the tree.
+#endif
+    judo_size index; // Number of elements scanned, including skipped elements, when parsing with a projection.
+    struct judo_span name; // Name of the member whose value is scanned next when parsing with a projection.
+    int32_t step; // Projection step matched by the array or object.
+    int32_t next_step; // Projection step matched by the name of the member whose value is scanned next.
+    bool array; // True if an array, rather than an object, is being measured or projected.
 };
 
 struct context
@@ -70,13 +171,236 @@ struct context
     judo_memfunc memfunc; // User custom memory allocation function.
     const char *string;
     judo_value *root; // Root value of the JSON structure.
+#if defined(JUDO_WITH_SIZED_PARSING)
+    uint8_t *block; // Memory the tree is allocated from when its size is computed upfront.
+    size_t block_used;
+    size_t block_size;
+#endif
+    uint32_t flags; // Parse flags passed to judo_parseopt().
+    const struct judo_projection *projection; // Paths of the values to build (or null to build every value).
+    bool skip; // Set when the projection rejects an array or object so that it's skipped with judo_scan_skip().
+    int32_t batch; // Number of tokens scanned at a time with a projection.
+    int32_t depth; // Maximum nesting depth.
     int32_t stack_depth;
-    struct parse_stack stack[JUDO_MAXDEPTH]; // Arrays and objects.
+    int32_t stack_capacity; // Number of levels the parse stack and the scanner have room for.
+    struct parse_stack *stack; // Arrays and objects. This is 'fixed' unless the document nests deeper.
+    void *spill; // State of the scanner for levels deeper than JUDO_MAXDEPTH (or null).
+    struct parse_stack fixed[JUDO_MAXDEPTH];
 };
 
-static void *judo_alloc(struct context *ctx, size_t size)
+#if defined(JUDO_WITH_SIZED_PARSING)
+static size_t align_to(size_t size, size_t alignment)
+{
+    return (size + (alignment - 1u)) & ~(alignment - 1u);
+}
+
+static size_t block_align(size_t size)
 {
-    void *ptr = ctx->memfunc(ctx->udata, NULL, size);
+    return align_to(size, BLOCK_ALIGNMENT);
+}
+
+// Size of the header of a tree allocated in a single block. The root value follows it so
+// it's rounded up for the root to be aligned even if it's a converted number.
+static size_t header_size(void)
+{
+    return align_to(sizeof(struct block), CONVERTED_ALIGNMENT);
+}
+#endif
+
+// Obtains memory from the memory function. The arena aligns allocations to BLOCK_ALIGNMENT unless
+// asked otherwise, whereas other memory functions are expected to align memory like malloc().
+static void *allocate(const struct context *ctx, size_t size, size_t alignment)
+{
+    void *ptr;
+    if (ctx->memfunc == judo_arenafunc)
+    {
+        ptr = judo_arenaalign(ctx->udata, size, alignment); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+    }
+    else
+    {
+        ptr = ctx->memfunc(ctx->udata, NULL, size);
+    }
+    return ptr;
+}
+
+// Releases the parse stack and the scanner state if they grew beyond JUDO_MAXDEPTH levels.
+static void release_stack(struct context *ctx)
+{
+    if (ctx->stack != ctx->fixed)
+    {
+        (void)ctx->memfunc(ctx->udata, ctx->stack, (size_t)ctx->stack_capacity * sizeof(ctx->stack[0]));
+        (void)ctx->memfunc(ctx->udata, ctx->spill, judo_stacksize(ctx->stack_capacity));
+    }
+}
+
+// Ensures the parse stack and the scanner have room for the levels a batch of tokens can nest
+// beneath 'level'. Each token nests at most one level deeper and the scanner keeps a level for
+// the root and for the value it's parsing. Levels beyond JUDO_MAXDEPTH are kept in memory from
+// the allocator which grows by doubling so that shallow documents needn't allocate any.
+static enum judo_result reserve_depth(struct context *ctx, struct judo_stream *stream, int32_t level)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    int32_t needed = ctx->depth;
+
+    if (level < (ctx->depth - (SCAN_BATCH_SIZE + 2)))
+    {
+        needed = level + SCAN_BATCH_SIZE + 2;
+    }
+
+    if (needed > ctx->stack_capacity)
+    {
+        int32_t capacity = ctx->stack_capacity;
+        while (capacity < needed)
+        {
+            capacity = (capacity > (ctx->depth / 2)) ? ctx->depth : (capacity * 2);
+        }
+
+        struct parse_stack *stack = NULL;
+        void *spill = NULL;
+        if ((size_t)capacity <= (SIZE_MAX / sizeof(stack[0])))
+        {
+            stack = ctx->memfunc(ctx->udata, NULL, (size_t)capacity * sizeof(stack[0])); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+            spill = ctx->memfunc(ctx->udata, NULL, judo_stacksize(capacity));
+        }
+
+        if ((stack == NULL) || (spill == NULL))
+        {
+            if (stack != NULL)
+            {
+                (void)ctx->memfunc(ctx->udata, stack, (size_t)capacity * sizeof(stack[0]));
+            }
+            if (spill != NULL)
+            {
+                (void)ctx->memfunc(ctx->udata, spill, judo_stacksize(capacity));
+            }
+            result = JUDO_RESULT_OUT_OF_MEMORY;
+        }
+        else
+        {
+            // The scanner copies its state from the previous stack so it must be released afterwards.
+            (void)memcpy(stack, ctx->stack, (size_t)ctx->stack_capacity * sizeof(stack[0]));
+            (void)memset(&stack[ctx->stack_capacity], 0, (size_t)(capacity - ctx->stack_capacity) * sizeof(stack[0]));
+            (void)judo_setdepth(stream, spill, capacity);
+            release_stack(ctx);
+            ctx->stack = stack;
+            ctx->spill = spill;
+            ctx->stack_capacity = capacity;
+        }
+    }
+    else
+    {
+        // The stream may have been copied before the stack last grew.
+        (void)judo_setdepth(stream, ctx->spill, ctx->stack_capacity);
+    }
+
+    return result;
+}
+
+// Skips the array or object rejected by the projection. It's validated as though it were parsed
+// so the errors are the same. If it nests deeper than the scanner has room for, then its brackets
+// are counted to learn how deep it nests, the scanner is grown straight to that depth, and the value
+// is skipped again from its opening bracket. Therefore it's scanned at most twice.
+static enum judo_result skip_value(struct context *ctx, struct judo_stream *stream, const char *source, judo_size length)
+{
+    const struct judo_stream begin = *stream;
+    enum judo_result result = judo_scan_skip(stream, source, length, 0u);
+
+    ctx->skip = false;
+    if ((result == JUDO_RESULT_MAXIMUM_NESTING) && (ctx->stack_capacity < ctx->depth))
+    {
+        // The copy is restored before the scanner grows since growing releases the spill it refers
+        // to. It must not be restored afterwards or the scanner would be left with the stale spill.
+        *stream = begin;
+        const judo_size nesting = judo_nesting(stream, source, length);
+        int32_t level = ctx->depth;
+        if (nesting < (judo_size)(ctx->depth - ctx->stack_depth))
+        {
+            level = ctx->stack_depth + (int32_t)nesting;
+        }
+
+        result = reserve_depth(ctx, stream, level);
+        if (result == JUDO_RESULT_SUCCESS)
+        {
+            result = judo_scan_skip(stream, source, length, 0u);
+        }
+    }
+
+    return result;
+}
+
+// Returns the number of tokens to scan at a time beneath 'level' kept arrays and objects. With a
+// projection, the stream is rewound to the beginning of the batch if an array or object in the middle
+// of it is rejected. That's only possible while the stream itself holds the kinds of every container
+// that's open, because the batch may overwrite the kinds held in its spill, so beneath that many
+// levels the tokens are scanned one at a time instead.
+static int32_t batch_size(const struct context *ctx, int32_t level)
+{
+    int32_t size = SCAN_BATCH_SIZE;
+    if (ctx->projection == NULL)
+    {
+        // No action.
+    }
+    else if (level >= (JUDO_MAXDEPTH - 2))
+    {
+        size = 1;
+    }
+    else
+    {
+        size = ctx->batch;
+    }
+    return size;
+}
+
+// Doubles the batch size after a batch is scanned without rejecting an array or object.
+static void widen_batch(struct context *ctx)
+{
+    ctx->batch = (ctx->batch > (SCAN_BATCH_SIZE / 2)) ? SCAN_BATCH_SIZE : (ctx->batch * 2);
+}
+
+// Skips the array or object rejected by the projection whose opening bracket is the last of the
+// 'processed' tokens of the batch which was scanned from 'start'. If the batch continued past it,
+// then the stream is rewound and the batch is scanned again up to the bracket since judo_scan_skip()
+// begins at the current token. The batch size is then shrunk to the distance to the bracket so that
+// rejected values which recur at a regular interval, like the members of similar objects, end their
+// batch rather than being scanned past again.
+static enum judo_result skip_rejected(struct context *ctx, struct judo_stream *stream, const struct judo_stream *start, const char *source, judo_size length, struct judo_item *items, int32_t processed, int32_t count, enum judo_result scanned)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+
+    if ((processed < count) || (scanned != JUDO_RESULT_SUCCESS))
+    {
+        int32_t rescanned = 0;
+        ctx->batch = processed;
+        *stream = *start;
+        result = judo_scan_many(stream, source, length, items, processed, &rescanned);
+        assert((result != JUDO_RESULT_SUCCESS) || (rescanned == processed)); // LCOV_EXCL_BR_LINE
+    }
+
+    if (result == JUDO_RESULT_SUCCESS)
+    {
+        result = skip_value(ctx, stream, source, length);
+    }
+
+    return result;
+}
+
+static void *judo_alloc_aligned(struct context *ctx, size_t size, size_t alignment)
+{
+    void *ptr;
+#if defined(JUDO_WITH_SIZED_PARSING)
+    if (ctx->block != NULL)
+    {
+        ctx->block_used = align_to(ctx->block_used, alignment);
+        assert((ctx->block_used + block_align(size)) <= ctx->block_size); // LCOV_EXCL_BR_LINE
+        ptr = &ctx->block[ctx->block_used];
+        ctx->block_used += block_align(size);
+    }
+    else
+#endif
+    {
+        ptr = allocate(ctx, size, alignment);
+    }
+
     if (ptr != NULL)
     {
         (void)memset(ptr, 0, size);
@@ -84,6 +408,11 @@ static void *judo_alloc(struct context *ctx, size_t size)
     return ptr;
 }
 
+static void *judo_alloc(struct context *ctx, size_t size)
+{
+    return judo_alloc_aligned(ctx, size, BLOCK_ALIGNMENT);
+}
+
 static struct object *to_object(void *value)
 {
     struct object *object = (struct object *)value; // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
@@ -163,12 +492,320 @@ static void track(struct context *ctx, judo_value *value)
     }
 }
 
-static enum judo_result process_value(struct context *ctx, const struct judo_stream *js)
+static uint32_t hash_bytes(uint32_t hash, const char *bytes, judo_size count)
+{
+    uint32_t h = hash;
+    for (judo_size i = 0; i < count; i++)
+    {
+        h = (h ^ (uint32_t)(uint8_t)bytes[i]) * FNV_PRIME;
+    }
+    return h;
+}
+
+// Hashes the unescaped name of an object member.
+static uint32_t hash_name(const char *source, struct judo_span name)
+{
+    const char *lexeme = &source[name.offset];
+    struct judo_span content;
+    uint32_t hash = FNV_OFFSET_BASIS;
+
+    if (judo_verbatim(lexeme, name.length, &content))
+    {
+        hash = hash_bytes(hash, &lexeme[content.offset], content.length);
+    }
+    else
+    {
+        char bytes[4];
+        judo_size index = 0;
+        int32_t count = judo_unescape(lexeme, name.length, &index, bytes);
+        while (count > 0)
+        {
+            hash = hash_bytes(hash, bytes, count);
+            count = judo_unescape(lexeme, name.length, &index, bytes);
+        }
+    }
+    return hash;
+}
+
+// The hash table of an object is kept at most half full so that probe sequences stay short.
+static uint32_t table_capacity(judo_size size)
+{
+    uint32_t capacity = 1u;
+    while (capacity < ((uint32_t)size * 2u))
+    {
+        capacity <<= 1u;
+    }
+    return capacity;
+}
+
+// Builds the hash table of an object once all of its members are known.
+static enum judo_result hash_object(struct context *ctx, struct object *object)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    if (object->size >= JUDO_HASH_THRESHOLD)
+    {
+        const uint32_t capacity = table_capacity(object->size);
+        object->slots = judo_alloc(ctx, (size_t)capacity * sizeof(object->slots[0])); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+        if (object->slots == NULL)
+        {
+            result = JUDO_RESULT_OUT_OF_MEMORY;
+        }
+        else
+        {
+            // Members are inserted in order so that the first member with a name is found first.
+            const uint32_t mask = capacity - 1u;
+            object->capacity = capacity;
+            for (judo_member *member = object->members; member != NULL; member = member->next)
+            {
+                const uint32_t hash = hash_name(ctx->string, member->name);
+                uint32_t index = hash & mask;
+                while (object->slots[index].member != NULL)
+                {
+                    index = (index + 1u) & mask;
+                }
+                object->slots[index].member = member;
+                object->slots[index].hash = hash;
+            }
+        }
+    }
+    return result;
+}
+
+// Builds the element pointer vector of an array once all of its elements are known.
+static enum judo_result index_array(struct context *ctx, struct array *array)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    if (array->length > 0)
+    {
+        array->elements = judo_alloc(ctx, (size_t)array->length * sizeof(array->elements[0])); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+        if (array->elements == NULL)
+        {
+            result = JUDO_RESULT_OUT_OF_MEMORY;
+        }
+        else
+        {
+            judo_value *element = array->next;
+            for (judo_size i = 0; i < array->length; i++)
+            {
+                assert(element != NULL); // LCOV_EXCL_BR_LINE
+                array->elements[i] = element;
+                element = element->next;
+            }
+        }
+    }
+    return result;
+}
+
+#if defined(JUDO_HAVE_FLOATS)
+// Checks if an integer converts to judo_number exactly, in which case the conversion is
+// independent of the rounding mode.
+static bool is_exact_number(int64_t integer)
+{
+#if NUMBER_MANT_DIG < 64
+    const uint64_t magnitude = (integer < 0) ? (0u - (uint64_t)integer) : (uint64_t)integer;
+    return magnitude <= (UINT64_C(1) << NUMBER_MANT_DIG);
+#else
+    (void)integer;
+    return true;
+#endif
+}
+
+// Checks if a floating-point number is an integer within the range of int64_t. The limits
+// are powers of two so they're exact. The upper limit is included since the integer beneath
+// it may have rounded up to it.
+static bool is_integral(judo_number real)
+{
+    const judo_number limit = -(judo_number)INT64_MIN;
+    bool integral = false;
+    if ((real >= -limit) && (real <= limit))
+    {
+        integral = (real == limit) || ((judo_number)(int64_t)real == real);
+    }
+    return integral;
+}
+
+static uint8_t convert_real(const char *lexeme, judo_size length, judo_number *real)
+{
+    uint8_t flags = (uint8_t)VALUE_REAL;
+    if (judo_numberify(lexeme, length, real) != JUDO_RESULT_SUCCESS)
+    {
+        flags |= (uint8_t)VALUE_OVERFLOW;
+    }
+    return flags;
+}
+#endif
+
+// Converts a number value while parsing so that judo_tointeger() and judo_tonumber() needn't
+// examine its lexeme. The lexeme was scanned moments ago so it's likely still cached.
+static void convert_number(const struct context *ctx, struct converted *converted)
+{
+    const enum judo_numtype numtype = (enum judo_numtype)converted->number.numtype;
+    const struct judo_span where = converted->number.descriptor.where;
+    const char *lexeme = &ctx->string[where.offset];
+    uint8_t flags = (uint8_t)VALUE_CONVERTED;
+
+#if defined(JUDO_HAVE_FLOATS)
+    if ((numtype == JUDO_NUMTYPE_DECIMAL) || (numtype == JUDO_NUMTYPE_SPECIAL))
+    {
+        // Decimals are rarely integers so the integer conversion is only attempted if the
+        // floating-point number is integral.
+        flags |= convert_real(lexeme, where.length, &converted->real);
+        if ((numtype == JUDO_NUMTYPE_DECIMAL) && is_integral(converted->real))
+        {
+            if (judo_integerify(lexeme, where.length, &converted->integer) == JUDO_RESULT_SUCCESS)
+            {
+                flags |= (uint8_t)VALUE_INTEGER;
+            }
+        }
+    }
+    else
+    {
+        // The floating-point number is stored too if converting the integer would round
+        // or lose the sign of negative zero.
+        if (judo_integerify(lexeme, where.length, &converted->integer) == JUDO_RESULT_SUCCESS)
+        {
+            flags |= (uint8_t)VALUE_INTEGER;
+        }
+
+        if (((flags & VALUE_INTEGER) == 0u) || !is_exact_number(converted->integer) || ((converted->integer == 0) && (lexeme[0] == '-')))
+        {
+            flags |= convert_real(lexeme, where.length, &converted->real);
+        }
+    }
+#else
+    if (numtype != JUDO_NUMTYPE_SPECIAL)
+    {
+        if (judo_integerify(lexeme, where.length, &converted->integer) == JUDO_RESULT_SUCCESS)
+        {
+            flags |= (uint8_t)VALUE_INTEGER;
+        }
+    }
+#endif
+
+    converted->number.descriptor.flags |= flags;
+}
+
+static enum judo_result add_member(struct context *ctx, struct judo_span name)
 {
     enum judo_result result = JUDO_RESULT_SUCCESS;
-    if (js->token == JUDO_TOKEN_ARRAY_BEGIN)
+    assert(ctx->stack_depth > 0); // LCOV_EXCL_BR_LINE
+
+    // There must be an object being parsed to have received this value.
+    struct parse_stack *top = &ctx->stack[ctx->stack_depth - 1];
+    assert(top->collection->type == (uint8_t)JUDO_TYPE_OBJECT); // LCOV_EXCL_BR_LINE
+
+    // Allocate a structure to represent the object member.
+    judo_member *member = judo_alloc(ctx, sizeof(member[0])); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+    if (member == NULL)
     {
-        assert (ctx->stack_depth < JUDO_MAXDEPTH); // LCOV_EXCL_BR_LINE
+        result = JUDO_RESULT_OUT_OF_MEMORY;
+    }
+    else
+    {
+        // Save the lexeme location.
+        member->name = name;
+
+        // Link the object name into the linked list.
+        struct object *object = to_object(top->collection);
+        if (object->members == NULL)
+        {
+            assert(top->members_tail == NULL); // LCOV_EXCL_BR_LINE
+            object->members = member;
+            top->members_tail = member;
+        }
+        else
+        {
+            top->members_tail->next = member;
+            top->members_tail = member;
+        }
+    }
+    return result;
+}
+
+// Decides whether a token is kept when parsing with a projection. The token is kept if it's part of a
+// value matched by a path or an array or object enclosing one. Arrays and objects which aren't kept
+// are flagged with 'skip' so that the caller passes over them with judo_scan_skip(), therefore their
+// tokens are never seen here. The 'depth' is the number of kept arrays and objects which are open.
+// If the kept value is the value of an object member, then 'member' is set since the member isn't
+// added when its name is scanned.
+static bool project(struct context *ctx, int32_t depth, const struct judo_item *item, bool *member)
+{
+    const enum judo_token token = item->token;
+    const bool begin = (token == JUDO_TOKEN_ARRAY_BEGIN) || (token == JUDO_TOKEN_OBJECT_BEGIN);
+    const bool end = (token == JUDO_TOKEN_ARRAY_END) || (token == JUDO_TOKEN_OBJECT_END);
+    int32_t step = 0;
+    bool keep = false;
+
+    *member = false;
+    if (end || (token == JUDO_TOKEN_EOF))
+    {
+        keep = true;
+    }
+    else if (depth == 0)
+    {
+        // The root value is always kept so that parsing succeeds with a tree.
+        keep = true;
+    }
+    else
+    {
+        struct parse_stack *top = &ctx->stack[depth - 1];
+        if (token == JUDO_TOKEN_OBJECT_NAME)
+        {
+            top->next_step = judo_projmember(ctx->projection, top->step, &ctx->string[item->where.offset], item->where.length);
+            top->name = item->where;
+        }
+        else
+        {
+            if (top->array)
+            {
+                step = judo_projelement(ctx->projection, top->step, top->index);
+                top->index += 1;
+            }
+            else
+            {
+                step = top->next_step;
+            }
+
+            // Scalars are kept if they're selected, but arrays and objects are also kept if a path descends into them.
+            keep = (step >= 0) && (begin || judo_projselected(ctx->projection, step));
+            *member = keep && !top->array;
+            ctx->skip = begin && !keep;
+        }
+    }
+
+    if (keep && begin)
+    {
+        assert(depth < ctx->stack_capacity); // LCOV_EXCL_BR_LINE
+        ctx->stack[depth].array = (token == JUDO_TOKEN_ARRAY_BEGIN);
+        ctx->stack[depth].index = 0;
+        ctx->stack[depth].step = step;
+    }
+
+    return keep;
+}
+
+static enum judo_result process_value(struct context *ctx, const struct judo_item *item)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    bool keep = true;
+    bool member = false;
+
+    if (ctx->projection != NULL)
+    {
+        keep = project(ctx, ctx->stack_depth, item, &member);
+        if (member)
+        {
+            result = add_member(ctx, ctx->stack[ctx->stack_depth - 1].name);
+        }
+    }
+
+    if (!keep || (result != JUDO_RESULT_SUCCESS))
+    {
+        // No action.
+    }
+    else if (item->token == JUDO_TOKEN_ARRAY_BEGIN)
+    {
+        assert (ctx->stack_depth < ctx->stack_capacity); // LCOV_EXCL_BR_LINE
         struct array *array = judo_alloc(ctx, sizeof(array[0])); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
         if (array == NULL)
         {
@@ -177,16 +814,16 @@ static enum judo_result process_value(struct context *ctx, const struct judo_str
         else
         {
             array->descriptor.type = JUDO_TYPE_ARRAY;
-            array->descriptor.where = js->where;
+            array->descriptor.where = item->where;
             track(ctx, &array->descriptor);
 
             ctx->stack[ctx->stack_depth].collection = &array->descriptor;
             ctx->stack_depth += 1;
         }
     }
-    else if (js->token == JUDO_TOKEN_OBJECT_BEGIN)
+    else if (item->token == JUDO_TOKEN_OBJECT_BEGIN)
     {
-        assert (ctx->stack_depth < JUDO_MAXDEPTH); // LCOV_EXCL_BR_LINE
+        assert (ctx->stack_depth < ctx->stack_capacity); // LCOV_EXCL_BR_LINE
         struct object *object = judo_alloc(ctx, sizeof(object[0])); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
         if (object == NULL)
         {
@@ -195,25 +832,37 @@ static enum judo_result process_value(struct context *ctx, const struct judo_str
         else
         {
             object->descriptor.type = JUDO_TYPE_OBJECT;
-            object->descriptor.where = js->where;
+            object->descriptor.where = item->where;
             track(ctx, &object->descriptor);
 
             ctx->stack[ctx->stack_depth].collection = &object->descriptor;
             ctx->stack_depth += 1;
         }
     }
-    else if ((js->token == JUDO_TOKEN_ARRAY_END) ||
-             (js->token == JUDO_TOKEN_OBJECT_END))
+    else if ((item->token == JUDO_TOKEN_ARRAY_END) ||
+             (item->token == JUDO_TOKEN_OBJECT_END))
     {
         assert(ctx->stack_depth > 0); // LCOV_EXCL_BR_LINE
         struct parse_stack *top = &ctx->stack[ctx->stack_depth - 1];
-        top->collection->where.length = (js->where.offset + js->where.length) - top->collection->where.offset;
+        top->collection->where.length = (item->where.offset + item->where.length) - top->collection->where.offset;
+        if ((item->token == JUDO_TOKEN_ARRAY_END) && ((ctx->flags & JUDO_PARSE_INDEXARRAYS) != 0u))
+        {
+            result = index_array(ctx, to_array(top->collection));
+        }
+        else if ((item->token == JUDO_TOKEN_OBJECT_END) && ((ctx->flags & JUDO_PARSE_HASHOBJECTS) != 0u))
+        {
+            result = hash_object(ctx, to_object(top->collection));
+        }
+        else
+        {
+            // No action.
+        }
         top->collection = NULL;
         top->elements_tail = NULL;
         top->members_tail = NULL;
         ctx->stack_depth -= 1;
     }
-    else if (js->token == JUDO_TOKEN_NULL)
+    else if (item->token == JUDO_TOKEN_NULL)
     {
         judo_value *value = judo_alloc(ctx, sizeof(value[0])); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
         if (value == NULL)
@@ -223,12 +872,12 @@ static enum judo_result process_value(struct context *ctx, const struct judo_str
         else
         {
             value->type = JUDO_TYPE_NULL;
-            value->where = js->where;
+            value->where = item->where;
             track(ctx, value);
         }
     }
-    else if ((js->token == JUDO_TOKEN_TRUE) ||
-             (js->token == JUDO_TOKEN_FALSE))
+    else if ((item->token == JUDO_TOKEN_TRUE) ||
+             (item->token == JUDO_TOKEN_FALSE))
     {
         struct boolean *boolean = judo_alloc(ctx, sizeof(boolean[0])); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
         if (boolean == NULL)
@@ -238,82 +887,261 @@ static enum judo_result process_value(struct context *ctx, const struct judo_str
         else
         {
             boolean->descriptor.type = JUDO_TYPE_BOOL;
-            boolean->descriptor.where = js->where;
-            boolean->value = (js->token == JUDO_TOKEN_TRUE) ? (uint8_t)1 : (uint8_t)0;
+            boolean->descriptor.where = item->where;
+            boolean->value = (item->token == JUDO_TOKEN_TRUE) ? (uint8_t)1 : (uint8_t)0;
             track(ctx, &boolean->descriptor);
         }
-    }
-    else if (js->token == JUDO_TOKEN_NUMBER)
-    {
-        judo_value *value = judo_alloc(ctx, sizeof(value[0])); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
-        if (value == NULL)
+    }
+    else if (item->token == JUDO_TOKEN_NUMBER)
+    {
+        const bool convert = ((ctx->flags & JUDO_PARSE_CONVERTNUMBERS) != 0u);
+        struct number *number = convert ? judo_alloc_aligned(ctx, sizeof(struct converted), CONVERTED_ALIGNMENT) : judo_alloc(ctx, sizeof(struct number)); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+        if (number == NULL)
+        {
+            result = JUDO_RESULT_OUT_OF_MEMORY;
+        }
+        else
+        {
+            number->descriptor.type = JUDO_TYPE_NUMBER;
+            number->descriptor.where = item->where;
+            number->digits = item->digits;
+            number->numtype = (uint8_t)item->numtype;
+            if (convert)
+            {
+                convert_number(ctx, (struct converted *)(void *)number); // cppcheck-suppress misra-c2012-11.3 ; Cast from number to its converted node.
+            }
+            track(ctx, &number->descriptor);
+        }
+    }
+    else if (item->token == JUDO_TOKEN_STRING)
+    {
+        judo_value *value = judo_alloc(ctx, sizeof(value[0])); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+        if (value == NULL)
+        {
+            result = JUDO_RESULT_OUT_OF_MEMORY;
+        }
+        else
+        {
+            value->type = JUDO_TYPE_STRING;
+            value->where = item->where;
+            if (item->escaped)
+            {
+                value->flags |= (uint8_t)VALUE_ESCAPED;
+            }
+            track(ctx, value);
+        }
+    }
+    else if (item->token == JUDO_TOKEN_OBJECT_NAME)
+    {
+        result = add_member(ctx, item->where);
+    }
+    else
+    {
+        assert(item->token == JUDO_TOKEN_EOF); // LCOV_EXCL_BR_LINE
+    }
+
+    return result;
+}
+
+#if defined(JUDO_WITH_SIZED_PARSING)
+// Number of bytes required for the tree node representing a token.
+static size_t node_size(enum judo_token token, uint32_t flags)
+{
+    size_t size;
+
+    switch (token)
+    {
+    case JUDO_TOKEN_NULL:
+    case JUDO_TOKEN_STRING:
+        size = sizeof(judo_value);
+        break;
+
+    case JUDO_TOKEN_NUMBER:
+        size = ((flags & JUDO_PARSE_CONVERTNUMBERS) != 0u) ? sizeof(struct converted) : sizeof(struct number);
+        break;
+
+    case JUDO_TOKEN_TRUE:
+    case JUDO_TOKEN_FALSE:
+        size = sizeof(struct boolean);
+        break;
+
+    case JUDO_TOKEN_ARRAY_BEGIN:
+        size = sizeof(struct array);
+        break;
+
+    case JUDO_TOKEN_OBJECT_BEGIN:
+        size = sizeof(struct object);
+        break;
+
+    case JUDO_TOKEN_OBJECT_NAME:
+        size = sizeof(judo_member);
+        break;
+
+    default:
+        size = 0;
+        break;
+    }
+
+    return size;
+}
+
+// Scans the entire input to compute the number of bytes required for the tree. The input is
+// validated in the process so building the tree afterwards can only fail for lack of memory.
+static enum judo_result measure_tree(struct context *ctx, struct judo_stream *stream, const char *source, judo_size length, size_t *size)
+{
+    enum judo_result result;
+    struct judo_item items[SCAN_BATCH_SIZE];
+    const uint32_t flags = ctx->flags;
+    int32_t depth = 0;
+
+    *size = header_size();
+    do
+    {
+        int32_t count = 0;
+        int32_t processed = 0;
+        struct judo_stream start;
+        result = reserve_depth(ctx, stream, depth);
+        if (result == JUDO_RESULT_SUCCESS)
+        {
+            start = *stream;
+            result = judo_scan_many(stream, source, length, items, batch_size(ctx, depth), &count);
+        }
+
+        struct parse_stack *stack = ctx->stack;
+        for (int32_t i = 0; (i < count) && !ctx->skip; i++)
+        {
+            processed = i + 1;
+            const enum judo_token token = items[i].token;
+            bool member = false;
+            bool keep = true;
+
+            // With a projection, the members of objects are counted with their values rather than their names.
+            if (ctx->projection != NULL)
+            {
+                keep = project(ctx, depth, &items[i], &member);
+                if (member)
+                {
+                    *size += block_align(sizeof(judo_member));
+                    stack[depth - 1].count += 1;
+                }
+            }
+
+            if (keep)
+            {
+                if ((token == JUDO_TOKEN_NUMBER) && ((flags & JUDO_PARSE_CONVERTNUMBERS) != 0u))
+                {
+                    *size = align_to(*size, CONVERTED_ALIGNMENT);
+                }
+                *size += block_align(node_size(token, flags));
+            }
+
+            // Count the elements of arrays and the members of objects.
+            if (keep && (depth > 0) && (node_size(token, flags) > 0u))
+            {
+                if (stack[depth - 1].array || (token == JUDO_TOKEN_OBJECT_NAME))
+                {
+                    stack[depth - 1].count += 1;
+                }
+            }
+
+            if (!keep)
+            {
+                // No action.
+            }
+            else if ((token == JUDO_TOKEN_ARRAY_BEGIN) || (token == JUDO_TOKEN_OBJECT_BEGIN))
+            {
+                assert(depth < ctx->stack_capacity); // LCOV_EXCL_BR_LINE
+                stack[depth].array = (token == JUDO_TOKEN_ARRAY_BEGIN);
+                stack[depth].count = 0;
+                depth += 1;
+            }
+            else if ((token == JUDO_TOKEN_ARRAY_END) || (token == JUDO_TOKEN_OBJECT_END))
+            {
+                assert(depth > 0); // LCOV_EXCL_BR_LINE
+                depth -= 1;
+
+                // Account for the element vector or hash table built when the array or object is closed.
+                const judo_size n = stack[depth].count;
+                if ((token == JUDO_TOKEN_ARRAY_END) && ((flags & JUDO_PARSE_INDEXARRAYS) != 0u))
+                {
+                    *size += block_align((size_t)n * sizeof(judo_value *));
+                }
+                else if ((token == JUDO_TOKEN_OBJECT_END) && ((flags & JUDO_PARSE_HASHOBJECTS) != 0u) && (n >= JUDO_HASH_THRESHOLD))
+                {
+                    *size += block_align((size_t)table_capacity(n) * sizeof(struct slot));
+                }
+                else
+                {
+                    // No action.
+                }
+            }
+            else
+            {
+                // No action.
+            }
+        }
+
+        if (ctx->skip)
         {
-            result = JUDO_RESULT_OUT_OF_MEMORY;
+            result = skip_rejected(ctx, stream, &start, source, length, items, processed, count, result);
         }
         else
         {
-            value->type = JUDO_TYPE_NUMBER;
-            value->where = js->where;
-            track(ctx, value);
+            widen_batch(ctx);
         }
-    }
-    else if (js->token == JUDO_TOKEN_STRING)
+    } while ((result == JUDO_RESULT_SUCCESS) && (stream->token != JUDO_TOKEN_EOF));
+
+    return result;
+}
+#endif
+
+// Builds the tree from the tokens of the input. If an error occurs, then 'where' is the span
+// of the source text responsible for it.
+static enum judo_result build_tree(struct context *ctx, struct judo_stream *stream, const char *source, judo_size length, struct judo_span *where)
+{
+    enum judo_result result;
+    struct judo_item items[SCAN_BATCH_SIZE];
+
+    do
     {
-        judo_value *value = judo_alloc(ctx, sizeof(value[0])); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
-        if (value == NULL)
+        // Tokens scanned before an error are processed first so that an out-of-memory
+        // error is reported for the same token it would be if they were scanned one by one.
+        int32_t count = 0;
+        int32_t processed = 0;
+        struct judo_stream start;
+        enum judo_result scanned = reserve_depth(ctx, stream, ctx->stack_depth);
+        if (scanned == JUDO_RESULT_SUCCESS)
         {
-            result = JUDO_RESULT_OUT_OF_MEMORY;
+            start = *stream;
+            scanned = judo_scan_many(stream, source, length, items, batch_size(ctx, ctx->stack_depth), &count);
         }
-        else
+        result = JUDO_RESULT_SUCCESS;
+        for (int32_t i = 0; (i < count) && (result == JUDO_RESULT_SUCCESS) && !ctx->skip; i++)
         {
-            value->type = JUDO_TYPE_STRING;
-            value->where = js->where;
-            track(ctx, value);
+            result = process_value(ctx, &items[i]);
+            *where = items[i].where;
+            processed = i + 1;
         }
-    }
-    else if (js->token == JUDO_TOKEN_OBJECT_NAME)
-    {
-        assert(ctx->stack_depth > 0); // LCOV_EXCL_BR_LINE
-
-        // There must be an object being parsed to have received this value.
-        struct parse_stack *top = &ctx->stack[ctx->stack_depth - 1];
-        assert(top->collection->type == (uint8_t)JUDO_TYPE_OBJECT); // LCOV_EXCL_BR_LINE
 
-        // Allocate a structure to represent the object member.
-        judo_member *member = judo_alloc(ctx, sizeof(member[0])); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
-        if (member == NULL)
-        {
-            result = JUDO_RESULT_OUT_OF_MEMORY;
-        }
-        else
+        if (result == JUDO_RESULT_SUCCESS)
         {
-            // Save the lexeme location.
-            member->name = js->where;
-
-            // Link the object name into the linked list.
-            struct object *object = to_object(top->collection);
-            if (object->members == NULL)
+            if (ctx->skip)
             {
-                assert(top->members_tail == NULL); // LCOV_EXCL_BR_LINE
-                object->members = member;
-                top->members_tail = member;
+                result = skip_rejected(ctx, stream, &start, source, length, items, processed, count, scanned);
             }
             else
             {
-                top->members_tail->next = member;
-                top->members_tail = member;
+                result = scanned;
+                widen_batch(ctx);
             }
+            *where = stream->where;
         }
-    }
-    else
-    {
-        assert(js->token == JUDO_TOKEN_EOF); // LCOV_EXCL_BR_LINE
-    }
+    } while ((result == JUDO_RESULT_SUCCESS) && (stream->token != JUDO_TOKEN_EOF));
 
     return result;
 }
 
-enum judo_result judo_parse(const char *source, int32_t length, judo_value **root, struct judo_error *error, void *udata, judo_memfunc memfunc) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+static enum judo_result parse(const char *source, judo_size length, judo_value **root, struct judo_error *error, void *udata, judo_memfunc memfunc, uint32_t flags, int32_t depth, const struct judo_projection *projection)
 {
     enum judo_result result;
 
@@ -321,6 +1149,11 @@ enum judo_result judo_parse(const char *source, int32_t length, judo_value **roo
     {
         result = JUDO_RESULT_INVALID_OPERATION;
     }
+    else if (depth <= 0)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+        *root = NULL;
+    }
     else if (source == NULL)
     {
         result = JUDO_RESULT_INVALID_OPERATION;
@@ -338,24 +1171,77 @@ enum judo_result judo_parse(const char *source, int32_t length, judo_value **roo
             .string = source,
             .udata = udata,
             .memfunc = memfunc,
+            .flags = flags,
+            .projection = projection,
+            .batch = SCAN_BATCH_SIZE,
+            .depth = depth,
+            .stack_capacity = (depth < JUDO_MAXDEPTH) ? depth : JUDO_MAXDEPTH,
         };
+        struct judo_span where = {0, 0};
+        ctx.stack = ctx.fixed;
 
-        for (;;)
+        // Validating the encoding upfront pays off for input with many non-ASCII characters, but
+        // it's a second pass over ASCII input so the caller must opt into it.
+        // If the input is malformed, then the scanner will report where.
+        if ((flags & JUDO_PARSE_PREVALIDATE) != 0u)
         {
-            result = judo_scan(&stream, source, length);
+            (void)judo_prevalidate(&stream, source, length);
+        }
+
+        result = JUDO_RESULT_SUCCESS;
+#if defined(JUDO_WITH_SIZED_PARSING)
+        if ((flags & JUDO_PARSE_SIZED) != 0u)
+        {
+            // The tree is measured with a copy of the stream so that it can be built
+            // afterwards by scanning the input again from the beginning.
+            struct judo_stream measure;
+            size_t size = 0;
+            (void)memcpy(&measure, &stream, sizeof(stream));
+            result = measure_tree(&ctx, &measure, source, length, &size);
             if (result == JUDO_RESULT_SUCCESS)
             {
-                result = process_value(&ctx, &stream);
+                struct block *block = allocate(&ctx, size, CONVERTED_ALIGNMENT); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+                if (block == NULL)
+                {
+                    result = JUDO_RESULT_OUT_OF_MEMORY;
+                }
+                else
+                {
+                    block->size = size;
+                    block->root = NULL;
+                    ctx.block = (uint8_t *)block; // cppcheck-suppress misra-c2012-11.3 ; Cast to byte pointer.
+                    ctx.block_used = header_size();
+                    ctx.block_size = size;
+                }
             }
-
-            if ((result != JUDO_RESULT_SUCCESS) || (stream.token == JUDO_TOKEN_EOF))
+            else
             {
-                break;
+                (void)memcpy(&stream, &measure, sizeof(stream));
+                where = stream.where;
             }
         }
+#endif
+
+        if (result == JUDO_RESULT_SUCCESS)
+        {
+            result = build_tree(&ctx, &stream, source, length, &where);
+        }
 
         if (result == JUDO_RESULT_SUCCESS)
         {
+#if defined(JUDO_WITH_SIZED_PARSING)
+            if (ctx.block != NULL)
+            {
+                // LCOV_EXCL_START
+                assert(ctx.block_used == ctx.block_size);
+                assert(ctx.root == (judo_value *)(void *)&ctx.block[header_size()]);
+                // LCOV_EXCL_STOP
+                struct block *block = (struct block *)(void *)ctx.block;
+                block->root = ctx.root;
+                ctx.root->flags |= (uint8_t)VALUE_BLOCK;
+            }
+#endif
+
             if (error != NULL)
             {
                 (void)memset(error, 0, sizeof(error[0]));
@@ -373,29 +1259,72 @@ enum judo_result judo_parse(const char *source, int32_t length, judo_value **roo
                 {
                     (void)memcpy(error->description, stream.error, JUDO_ERRMAX);
                 }
-                error->where = stream.where;
+                error->where = where;
             }
 
             // Use the result code from the scan operation, not the free operation.
-            (void)judo_free(ctx.root, udata, memfunc);
+#if defined(JUDO_WITH_SIZED_PARSING)
+            if (ctx.block != NULL)
+            {
+                (void)memfunc(udata, ctx.block, ctx.block_size);
+            }
+            else
+#endif
+            {
+                (void)judo_free(ctx.root, udata, memfunc);
+            }
             ctx.root = NULL;
         }
 
+        release_stack(&ctx);
         *root = ctx.root;
     }
 
     return result;
 }
 
-enum judo_result judo_free(judo_value *root, void *udata, judo_memfunc memfunc)
+enum judo_result judo_parsedepth(const char *source, judo_size length, judo_value **root, struct judo_error *error, void *udata, judo_memfunc memfunc, uint32_t flags, int32_t depth) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    return parse(source, length, root, error, udata, memfunc, flags, depth, NULL);
+}
+
+enum judo_result judo_parseproj(const char *source, judo_size length, judo_value **root, struct judo_error *error, void *udata, judo_memfunc memfunc, uint32_t flags, int32_t depth, const struct judo_projection *projection) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
 {
-    struct freestack
+    enum judo_result result;
+    if ((projection == NULL) || (projection->s_steps == NULL))
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+        if (root != NULL)
+        {
+            *root = NULL;
+        }
+    }
+    else
     {
-        judo_value *value;
-        judo_value *element;
-        judo_member *member;
-    };
+        result = parse(source, length, root, error, udata, memfunc, flags, depth, projection);
+    }
+    return result;
+}
+
+enum judo_result judo_parseopt(const char *source, judo_size length, judo_value **root, struct judo_error *error, void *udata, judo_memfunc memfunc, uint32_t flags) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    return judo_parsedepth(source, length, root, error, udata, memfunc, flags, JUDO_MAXDEPTH);
+}
+
+enum judo_result judo_parse(const char *source, judo_size length, judo_value **root, struct judo_error *error, void *udata, judo_memfunc memfunc) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    return judo_parseopt(source, length, root, error, udata, memfunc, 0);
+}
+
+#if defined(JUDO_WITH_SIZED_PARSING)
+enum judo_result judo_parsesized(const char *source, judo_size length, judo_value **root, struct judo_error *error, void *udata, judo_memfunc memfunc) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    return judo_parseopt(source, length, root, error, udata, memfunc, JUDO_PARSE_SIZED);
+}
+#endif
 
+enum judo_result judo_free(judo_value *root, void *udata, judo_memfunc memfunc)
+{
     enum judo_result result = JUDO_RESULT_SUCCESS;
 
     if (memfunc == NULL)
@@ -403,107 +1332,102 @@ enum judo_result judo_free(judo_value *root, void *udata, judo_memfunc memfunc)
         result = JUDO_RESULT_INVALID_OPERATION;
     }
 
-    if ((result == JUDO_RESULT_SUCCESS) && (root != NULL))
+#if defined(JUDO_WITH_SIZED_PARSING)
+    if ((result == JUDO_RESULT_SUCCESS) && (root != NULL) && ((root->flags & VALUE_BLOCK) != 0u))
     {
-        int32_t depth;
-        struct freestack stack[JUDO_MAXDEPTH] = {0}; // Arrays and objects.
-
-        depth = 1;
-        stack[0].value = root;
+        // The entire tree was allocated in a single block by judo_parsesized().
+        struct block *block = (struct block *)(void *)((uint8_t *)root - header_size()); // cppcheck-suppress misra-c2012-18.4 ; The block header precedes the root value.
+        assert(block->root == root); // LCOV_EXCL_BR_LINE
+        (void)memfunc(udata, block, block->size);
+    }
+    else
+#endif
+    // Trees allocated from an arena are released with the arena so there's nothing to walk.
+    if ((result == JUDO_RESULT_SUCCESS) && (root != NULL) && (memfunc != judo_arenafunc))
+    {
+        // The tree is freed without a stack, regardless of how deeply it nests, by linking the
+        // values which remain to be freed through their 'next' field. The elements of an array
+        // are already linked this way whereas the values of members aren't linked at all.
+        judo_value *pending = NULL;
+        judo_value *value = root;
 
-        while (depth > 0)
+        while (value != NULL)
         {
-            struct freestack *top = &stack[depth - 1];
-            if (top->element != NULL)
+            judo_value *element;
+            judo_member *member;
+
+            // LCOV_EXCL_BR_START
+            switch (judo_gettype(value))
+            // LCOV_EXCL_BR_STOP
             {
-                judo_value *next = judo_next(top->element);
-                if (next == NULL)
+            case JUDO_TYPE_NULL:
+            case JUDO_TYPE_STRING:
+                (void)memfunc(udata, value, sizeof(judo_value));
+                break;
+
+            case JUDO_TYPE_NUMBER:
+                (void)memfunc(udata, value, ((value->flags & VALUE_CONVERTED) != 0u) ? sizeof(struct converted) : sizeof(struct number));
+                break;
+
+            case JUDO_TYPE_BOOL:
+                (void)memfunc(udata, value, sizeof(struct boolean));
+                break;
+
+            case JUDO_TYPE_ARRAY:
+                element = judo_first(value);
+                if (element != NULL)
                 {
-                    top->value = top->element;
+                    judo_value *last = element;
+                    while (last->next != NULL)
+                    {
+                        last = last->next;
+                    }
+                    last->next = pending;
+                    pending = element;
                 }
-                else
+                if (to_array(value)->elements != NULL)
                 {
-                    stack[depth].value = top->element;
-                    depth += 1;
+                    (void)memfunc(udata, to_array(value)->elements, (size_t)to_array(value)->length * sizeof(judo_value *));
                 }
-                top->element = next;
-            }
-            else if (top->member != NULL)
-            {
-                judo_member *member = top->member;
-                judo_member *next = judo_membnext(member);
+                (void)memfunc(udata, value, sizeof(struct array));
+                break;
 
-                if (next == NULL)
+            case JUDO_TYPE_OBJECT:
+                member = judo_membfirst(value);
+                while (member != NULL)
                 {
-                    top->value = judo_membvalue(member);
+                    judo_member *next = member->next;
+                    if (member->value != NULL)
+                    {
+                        // The value is missing if parsing failed after the member name.
+                        member->value->next = pending;
+                        pending = member->value;
+                    }
+                    (void)memfunc(udata, member, sizeof(member[0]));
+                    member = next;
                 }
-                else
+                if (to_object(value)->slots != NULL)
                 {
-                    stack[depth].value = judo_membvalue(member);
-                    depth += 1;
+                    (void)memfunc(udata, to_object(value)->slots, (size_t)to_object(value)->capacity * sizeof(struct slot));
                 }
+                (void)memfunc(udata, value, sizeof(struct object));
+                break;
 
-                (void)memfunc(udata, member, sizeof(member[0]));
-                top->member = next;
-            }
-            else if (top->value == NULL)
-            {
-                depth -= 1;
+            // LCOV_EXCL_START
+            default:
+                result = JUDO_RESULT_MALFUNCTION; // This will never be reachable.
+                break;
+            // LCOV_EXCL_STOP
             }
-            else
-            {
-                judo_value *element;
-                judo_member *member;
-                judo_value *value = top->value;
-                assert(value != NULL); // LCOV_EXCL_BR_LINE
-                
-                (void)memset(top, 0, sizeof(top[0]));
-                depth -= 1; // Pop from the stack.
-
-                // LCOV_EXCL_BR_START
-                switch (judo_gettype(value))
-                // LCOV_EXCL_BR_STOP
-                {
-                case JUDO_TYPE_NULL:
-                case JUDO_TYPE_STRING:
-                case JUDO_TYPE_NUMBER:
-                    (void)memfunc(udata, value, sizeof(judo_value));
-                    break;
-
-                case JUDO_TYPE_BOOL:
-                    (void)memfunc(udata, value, sizeof(struct boolean));
-                    break;
-
-                case JUDO_TYPE_ARRAY:
-                    element = judo_first(value);
-                    if (element != NULL)
-                    {
-                        stack[depth].element = element;
-                        depth += 1;
-                    }
-                    (void)memfunc(udata, value, sizeof(struct array));
-                    break;
-
-                case JUDO_TYPE_OBJECT:
-                    member = judo_membfirst(value);
-                    if (member != NULL)
-                    {
-                        stack[depth].member = member;
-                        depth += 1;
-                    }
-                    (void)memfunc(udata, value, sizeof(struct object));
-                    break;
 
-                // LCOV_EXCL_START
-                default:
-                    result = JUDO_RESULT_MALFUNCTION; // This will never be reachable.
-                    break;
-                // LCOV_EXCL_STOP
-                }
+            value = pending;
+            if (pending != NULL)
+            {
+                pending = pending->next;
             }
         }
     }
-    
+
     return result;
 }
 
@@ -521,6 +1445,26 @@ enum judo_type judo_gettype(const judo_value *value) // cppcheck-suppress misra-
     return type;
 }
 
+enum judo_numtype judo_getnumtype(const judo_value *value, judo_size *digits) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_numtype numtype = JUDO_NUMTYPE_INVALID;
+    judo_size count = 0;
+
+    if ((value != NULL) && (value->type == (uint8_t)JUDO_TYPE_NUMBER))
+    {
+        const struct number *number = (const struct number *)(const void *)value; // cppcheck-suppress misra-c2012-11.3 ; Cast from value to its number node.
+        numtype = (enum judo_numtype)number->numtype;
+        count = number->digits;
+    }
+
+    if (digits != NULL)
+    {
+        *digits = count;
+    }
+
+    return numtype;
+}
+
 judo_value *judo_first(judo_value *value) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
 {
     judo_value *first;
@@ -535,6 +1479,32 @@ judo_value *judo_first(judo_value *value) // cppcheck-suppress misra-c2012-8.7 ;
     return first;
 }
 
+judo_value *judo_at(judo_value *value, judo_size index) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    judo_value *element = NULL;
+    if ((value != NULL) && (value->type == (uint8_t)JUDO_TYPE_ARRAY))
+    {
+        const struct array *array = to_array(value);
+        if ((index >= 0) && (index < array->length))
+        {
+            if (array->elements != NULL)
+            {
+                element = array->elements[index];
+            }
+            else
+            {
+                // The array wasn't indexed when it was parsed so walk its elements.
+                element = array->next;
+                for (judo_size i = 0; i < index; i++)
+                {
+                    element = element->next;
+                }
+            }
+        }
+    }
+    return element;
+}
+
 judo_value *judo_next(judo_value *value) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
 {
     judo_value *next;
@@ -590,6 +1560,89 @@ bool judo_tobool(judo_value *value) // cppcheck-suppress misra-c2012-8.7 ; Publi
     return b;
 }
 
+enum judo_result judo_tointeger(const judo_value *value, const char *source, int64_t *integer) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result;
+
+    if (value == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (value->type != (uint8_t)JUDO_TYPE_NUMBER)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (integer == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if ((value->flags & VALUE_INTEGER) != 0u)
+    {
+        const struct converted *converted = (const struct converted *)(const void *)value; // cppcheck-suppress misra-c2012-11.3 ; Cast from value to its converted node.
+        *integer = converted->integer;
+        result = JUDO_RESULT_SUCCESS;
+    }
+    else if ((value->flags & VALUE_CONVERTED) != 0u)
+    {
+        // The number was converted while parsing but isn't an integer.
+        result = JUDO_RESULT_OUT_OF_RANGE;
+    }
+    else if (source == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        result = judo_integerify(&source[value->where.offset], value->where.length, integer);
+    }
+
+    return result;
+}
+
+#if defined(JUDO_HAVE_FLOATS)
+enum judo_result judo_tonumber(const judo_value *value, const char *source, judo_number *number) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result;
+
+    if (value == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (value->type != (uint8_t)JUDO_TYPE_NUMBER)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (number == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if ((value->flags & VALUE_CONVERTED) != 0u)
+    {
+        // Integers without a floating-point number convert exactly.
+        const struct converted *converted = (const struct converted *)(const void *)value; // cppcheck-suppress misra-c2012-11.3 ; Cast from value to its converted node.
+        if ((value->flags & VALUE_REAL) != 0u)
+        {
+            *number = converted->real;
+        }
+        else
+        {
+            *number = (judo_number)converted->integer;
+        }
+        result = ((value->flags & VALUE_OVERFLOW) != 0u) ? JUDO_RESULT_OUT_OF_RANGE : JUDO_RESULT_SUCCESS;
+    }
+    else if (source == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        result = judo_numberify(&source[value->where.offset], value->where.length, number);
+    }
+
+    return result;
+}
+#endif
+
 struct judo_span judo_name2span(const judo_member *member) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
 {
     struct judo_span span = {0};
@@ -600,9 +1653,9 @@ struct judo_span judo_name2span(const judo_member *member) // cppcheck-suppress
     return span;
 }
 
-int32_t judo_len(judo_value *value) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+judo_size judo_len(judo_value *value) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
 {
-    int32_t length;
+    judo_size length;
     if (value != NULL)
     {
         if (value->type == (uint8_t)JUDO_TYPE_ARRAY)
@@ -625,6 +1678,46 @@ int32_t judo_len(judo_value *value) // cppcheck-suppress misra-c2012-8.7 ; Publi
     return length;
 }
 
+judo_value *judo_get(judo_value *value, const char *source, const char *key, judo_size keylen) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    judo_value *found = NULL;
+    if ((value != NULL) && (value->type == (uint8_t)JUDO_TYPE_OBJECT) && (source != NULL) && (key != NULL))
+    {
+        const struct object *object = to_object(value);
+        const judo_size length = (keylen < 0) ? (judo_size)strlen(key) : keylen;
+        if (object->slots != NULL)
+        {
+            // The table is at most half full so probing always reaches an unoccupied slot.
+            const uint32_t mask = object->capacity - 1u;
+            const uint32_t hash = hash_bytes(FNV_OFFSET_BASIS, key, length);
+            uint32_t index = hash & mask;
+            while ((found == NULL) && (object->slots[index].member != NULL))
+            {
+                const judo_member *member = object->slots[index].member;
+                if ((object->slots[index].hash == hash) && judo_nameeq(&source[member->name.offset], member->name.length, key, length))
+                {
+                    found = member->value;
+                }
+                index = (index + 1u) & mask;
+            }
+        }
+        else
+        {
+            // The object wasn't hashed when it was parsed so search its members.
+            const judo_member *member = object->members;
+            while ((found == NULL) && (member != NULL))
+            {
+                if (judo_nameeq(&source[member->name.offset], member->name.length, key, length))
+                {
+                    found = member->value;
+                }
+                member = member->next;
+            }
+        }
+    }
+    return found;
+}
+
 judo_value *judo_membvalue(judo_member *member) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
 {
     judo_value *value;
@@ -649,4 +1742,19 @@ struct judo_span judo_value2span(const judo_value *value) // cppcheck-suppress m
     return span;
 }
 
+const char *judo_strview(const judo_value *value, const char *source, judo_size *length) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    const char *string = NULL;
+    if ((value != NULL) && (source != NULL) && (length != NULL))
+    {
+        if ((value->type == (uint8_t)JUDO_TYPE_STRING) && ((value->flags & VALUE_ESCAPED) == 0u))
+        {
+            // Strings without escape sequences are identical to their lexeme without quotes.
+            string = &source[value->where.offset + 1];
+            *length = value->where.length - 2;
+        }
+    }
+    return string;
+}
+
 #endif
@@ -0,0 +1,527 @@
+/*
+ *  Judo - Embeddable JSON and JSON5 parser.
+ *  Copyright (c) 2025 Railgun Labs, LLC
+ *
+ *  This software is dual-licensed: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3 as
+ *  published by the Free Software Foundation. For the terms of this
+ *  license, see <https://www.gnu.org/licenses/>.
+ *
+ *  Alternatively, you can license this software under a proprietary
+ *  license, as set out in <https://railgunlabs.com/judo/license/>.
+ */
+
+// This file compiles the paths passed to judo_projinit() into a trie of "steps"
+// which judo_parseproj() walks as it parses. Each step matches a member name, an
+// array index, or, for the wildcard '*', anything. The trie is deterministic: at
+// most one child of a step matches a given member or element. This is achieved by
+// copying the subtree of a wildcard into each of its named siblings so that the
+// named sibling matches everything the wildcard would have matched too. The parser
+// then tracks a single step per level regardless of how the paths overlap.
+
+#include "judo.h"
+#include "judo_utils.h"
+
+#if defined(JUDO_PARSER)
+#include <string.h>
+#include <assert.h>
+
+// Number of steps allocated when the first step is added.
+#define INITIAL_CAPACITY 16
+
+// Flags for steps.
+#define STEP_WILDCARD 0x01u // The step matches every member and element.
+#define STEP_SELECTED 0x02u // A path ends at this step so its entire subtree is selected.
+
+struct step
+{
+    int32_t child; // First child step, or -1 if there are none.
+    int32_t sibling; // Next step with the same parent, or -1 if there are none.
+    int32_t mark; // Generation in which the step was last matched while compiling.
+    int32_t origin; // Step whose children remain to be copied to this step, or -1.
+    judo_size name; // Offset of the unescaped member name in the names buffer.
+    judo_size length; // Length of the unescaped member name.
+    judo_size index; // Array index denoted by the name, or -1 if it isn't an array index.
+    uint8_t flags;
+};
+
+struct compiler
+{
+    struct judo_projection *projection;
+    void *udata;
+    judo_memfunc memfunc;
+    int32_t generation;
+    judo_size names_used;
+};
+
+static struct step *steps_of(const struct judo_projection *projection)
+{
+    return (struct step *)projection->s_steps; // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+}
+
+// Appends a step and links it as the first child of 'parent'. Returns -1 if memory allocation fails.
+static int32_t new_step(struct compiler *compiler, int32_t parent, const struct step *prototype)
+{
+    struct judo_projection *projection = compiler->projection;
+    int32_t step = -1;
+
+    if (projection->s_count == projection->s_capacity)
+    {
+        const int32_t capacity = (projection->s_capacity == 0) ? INITIAL_CAPACITY : (projection->s_capacity * 2);
+        struct step *steps = compiler->memfunc(compiler->udata, NULL, (size_t)capacity * sizeof(steps[0])); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+        if (steps != NULL)
+        {
+            if (projection->s_steps != NULL)
+            {
+                (void)memcpy(steps, projection->s_steps, (size_t)projection->s_count * sizeof(steps[0]));
+                (void)compiler->memfunc(compiler->udata, projection->s_steps, (size_t)projection->s_capacity * sizeof(steps[0]));
+            }
+            projection->s_steps = steps;
+            projection->s_capacity = capacity;
+        }
+    }
+
+    if (projection->s_count < projection->s_capacity)
+    {
+        struct step *steps = steps_of(projection);
+        step = projection->s_count;
+        projection->s_count += 1;
+
+        steps[step] = *prototype;
+        steps[step].child = -1;
+        steps[step].sibling = -1;
+        steps[step].mark = 0;
+        steps[step].origin = -1;
+        if (parent >= 0)
+        {
+            steps[step].sibling = steps[parent].child;
+            steps[parent].child = step;
+        }
+    }
+
+    return step;
+}
+
+// Copies the subtree beneath 'origin' beneath 'step'. The copies are appended to the steps and the
+// steps from 'step' onward are visited in order so that they're copied breadth-first without recursion.
+static enum judo_result copy_children(struct compiler *compiler, int32_t step, int32_t origin)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    steps_of(compiler->projection)[step].origin = origin;
+
+    for (int32_t copy = step; (copy < compiler->projection->s_count) && (result == JUDO_RESULT_SUCCESS); copy++)
+    {
+        const int32_t from = steps_of(compiler->projection)[copy].origin;
+        if (from >= 0)
+        {
+            int32_t child = steps_of(compiler->projection)[from].child;
+            while ((child >= 0) && (result == JUDO_RESULT_SUCCESS))
+            {
+                const struct step prototype = steps_of(compiler->projection)[child];
+                const int32_t added = new_step(compiler, copy, &prototype);
+                if (added < 0)
+                {
+                    result = JUDO_RESULT_OUT_OF_MEMORY;
+                }
+                else
+                {
+                    steps_of(compiler->projection)[added].origin = child;
+                    child = prototype.sibling;
+                }
+            }
+            steps_of(compiler->projection)[copy].origin = -1;
+        }
+    }
+
+    return result;
+}
+
+static int32_t find_wildcard(const struct judo_projection *projection, int32_t step)
+{
+    const struct step *steps = steps_of(projection);
+    int32_t child = steps[step].child;
+    while ((child >= 0) && ((steps[child].flags & STEP_WILDCARD) == 0u))
+    {
+        child = steps[child].sibling;
+    }
+    return child;
+}
+
+static int32_t find_name(const struct judo_projection *projection, int32_t step, const char *name, judo_size length)
+{
+    const struct step *steps = steps_of(projection);
+    int32_t match = -1;
+    for (int32_t child = steps[step].child; (child >= 0) && (match < 0); child = steps[child].sibling)
+    {
+        const struct step *candidate = &steps[child];
+        if (((candidate->flags & STEP_WILDCARD) == 0u) && (candidate->length == length) && (memcmp(&projection->s_names[candidate->name], name, (size_t)length) == 0))
+        {
+            match = child;
+        }
+    }
+    return match;
+}
+
+// Converts a member name to the array index it denotes. Indices are decimal without leading zeros
+// and indices which can't exist, because the input can't be large enough, are rejected.
+static judo_size to_index(const char *name, judo_size length)
+{
+    judo_size index = 0;
+
+    if ((length == 0) || ((name[0] == '0') && (length > 1)))
+    {
+        index = -1;
+    }
+
+    for (judo_size i = 0; (i < length) && (index >= 0); i++)
+    {
+        if ((name[i] >= '0') && (name[i] <= '9') && (index <= (JUDO_MAXIMUM_INPUT_SIZE / 10)))
+        {
+            index = (index * 10) + (judo_size)(name[i] - '0');
+        }
+        else
+        {
+            index = -1;
+        }
+    }
+
+    return index;
+}
+
+// Advances every step matched by the path so far to its child matching the segment. The steps matched
+// so far are marked with the current generation and the children are marked with the next generation.
+static enum judo_result match_segment(struct compiler *compiler, const struct step *segment)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    struct judo_projection *projection = compiler->projection;
+    const int32_t generation = compiler->generation;
+
+    // Steps appended by this loop are never marked with the current generation so they aren't visited.
+    for (int32_t step = 0; (step < projection->s_count) && (result == JUDO_RESULT_SUCCESS); step++)
+    {
+        if (steps_of(projection)[step].mark == generation)
+        {
+            int32_t wildcard = find_wildcard(projection, step);
+            if ((segment->flags & STEP_WILDCARD) != 0u)
+            {
+                // Every named sibling already matches what the wildcard matches so the path is added to them too.
+                if (wildcard < 0)
+                {
+                    wildcard = new_step(compiler, step, segment);
+                }
+
+                if (wildcard < 0)
+                {
+                    result = JUDO_RESULT_OUT_OF_MEMORY;
+                }
+                else
+                {
+                    for (int32_t child = steps_of(projection)[step].child; child >= 0; child = steps_of(projection)[child].sibling)
+                    {
+                        steps_of(projection)[child].mark = generation + 1;
+                    }
+                }
+            }
+            else
+            {
+                // A new named step begins as a copy of the wildcard since it matches what the wildcard matches.
+                int32_t named = find_name(projection, step, &projection->s_names[segment->name], segment->length);
+                if (named < 0)
+                {
+                    named = new_step(compiler, step, segment);
+                    if ((named >= 0) && (wildcard >= 0))
+                    {
+                        steps_of(projection)[named].flags |= (uint8_t)(steps_of(projection)[wildcard].flags & STEP_SELECTED);
+                        result = copy_children(compiler, named, wildcard);
+                    }
+                }
+
+                if (named < 0)
+                {
+                    result = JUDO_RESULT_OUT_OF_MEMORY;
+                }
+                else
+                {
+                    steps_of(projection)[named].mark = generation + 1;
+                }
+            }
+        }
+    }
+
+    compiler->generation = generation + 1;
+    return result;
+}
+
+// Unescapes the segment of the path beginning at '*offset' into the names buffer and advances the
+// offset past it. The sequences "~0" and "~1" are unescaped to '~' and '/' like a JSON Pointer.
+static enum judo_result read_segment(struct compiler *compiler, const char *path, size_t *offset, struct step *segment)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    char *name = &compiler->projection->s_names[compiler->names_used];
+    size_t at = *offset;
+    judo_size length = 0;
+
+    while ((path[at] != '\0') && (path[at] != '/') && (result == JUDO_RESULT_SUCCESS))
+    {
+        if (path[at] != '~')
+        {
+            name[length] = path[at];
+            at += 1u;
+        }
+        else if (path[at + 1u] == '0')
+        {
+            name[length] = '~';
+            at += 2u;
+        }
+        else if (path[at + 1u] == '1')
+        {
+            name[length] = '/';
+            at += 2u;
+        }
+        else
+        {
+            result = JUDO_RESULT_INVALID_OPERATION;
+        }
+        length += 1;
+    }
+
+    (void)memset(segment, 0, sizeof(segment[0]));
+    if (((at - *offset) == 1u) && (path[*offset] == '*'))
+    {
+        segment->flags = (uint8_t)STEP_WILDCARD;
+        segment->index = -1;
+    }
+    else
+    {
+        segment->name = compiler->names_used;
+        segment->length = length;
+        segment->index = to_index(name, length);
+        compiler->names_used += length;
+    }
+
+    *offset = at;
+    return result;
+}
+
+static enum judo_result add_path(struct compiler *compiler, const char *path)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    struct judo_projection *projection = compiler->projection;
+    size_t offset = 0;
+
+    // Paths are empty, to select the whole document, or begin with a slash.
+    if ((path[0] != '\0') && (path[0] != '/'))
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+
+    compiler->generation += 1;
+    steps_of(projection)[0].mark = compiler->generation;
+
+    while ((path[offset] == '/') && (result == JUDO_RESULT_SUCCESS))
+    {
+        struct step segment;
+        offset += 1u;
+        result = read_segment(compiler, path, &offset, &segment);
+        if (result == JUDO_RESULT_SUCCESS)
+        {
+            result = match_segment(compiler, &segment);
+        }
+    }
+
+    if (result == JUDO_RESULT_SUCCESS)
+    {
+        for (int32_t step = 0; step < projection->s_count; step++)
+        {
+            if (steps_of(projection)[step].mark == compiler->generation)
+            {
+                steps_of(projection)[step].flags |= (uint8_t)STEP_SELECTED;
+            }
+        }
+    }
+
+    return result;
+}
+
+enum judo_result judo_projinit(struct judo_projection *projection, const char *const *paths, int32_t count, void *udata, judo_memfunc memfunc) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+
+    if ((projection == NULL) || (memfunc == NULL) || (count < 0) || ((paths == NULL) && (count > 0)))
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        (void)memset(projection, 0, sizeof(projection[0]));
+
+        // Unescaping never lengthens a path so the names fit in a buffer the size of all paths.
+        size_t size = 0;
+        for (int32_t i = 0; (i < count) && (result == JUDO_RESULT_SUCCESS); i++)
+        {
+            if (paths[i] == NULL)
+            {
+                result = JUDO_RESULT_INVALID_OPERATION;
+            }
+            else
+            {
+                size += strlen(paths[i]);
+                if (size > (size_t)JUDO_MAXIMUM_INPUT_SIZE)
+                {
+                    result = JUDO_RESULT_INPUT_TOO_LARGE;
+                }
+            }
+        }
+
+        if ((result == JUDO_RESULT_SUCCESS) && (size > 0u))
+        {
+            projection->s_names = memfunc(udata, NULL, size); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+            projection->s_size = size;
+            if (projection->s_names == NULL)
+            {
+                projection->s_size = 0;
+                result = JUDO_RESULT_OUT_OF_MEMORY;
+            }
+        }
+
+        struct compiler compiler = {
+            .projection = projection,
+            .udata = udata,
+            .memfunc = memfunc,
+        };
+
+        // The first step is the root value which is matched by every path.
+        if (result == JUDO_RESULT_SUCCESS)
+        {
+            const struct step root = {.index = -1};
+            if (new_step(&compiler, -1, &root) < 0)
+            {
+                result = JUDO_RESULT_OUT_OF_MEMORY;
+            }
+        }
+
+        for (int32_t i = 0; (i < count) && (result == JUDO_RESULT_SUCCESS); i++)
+        {
+            result = add_path(&compiler, paths[i]);
+        }
+
+        if (result != JUDO_RESULT_SUCCESS)
+        {
+            (void)judo_projfree(projection, udata, memfunc);
+        }
+    }
+
+    return result;
+}
+
+enum judo_result judo_projfree(struct judo_projection *projection, void *udata, judo_memfunc memfunc) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+
+    if ((projection == NULL) || (memfunc == NULL))
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        if (projection->s_steps != NULL)
+        {
+            (void)memfunc(udata, projection->s_steps, (size_t)projection->s_capacity * sizeof(struct step));
+        }
+        if (projection->s_names != NULL)
+        {
+            (void)memfunc(udata, projection->s_names, projection->s_size);
+        }
+        (void)memset(projection, 0, sizeof(projection[0]));
+    }
+
+    return result;
+}
+
+int32_t judo_projmember(const struct judo_projection *projection, int32_t step, const char *lexeme, judo_size length)
+{
+    const struct step *steps = steps_of(projection);
+    int32_t match = -1;
+
+    assert((step >= 0) && (step < projection->s_count)); // LCOV_EXCL_BR_LINE
+    if ((steps[step].flags & STEP_SELECTED) != 0u)
+    {
+        match = step;
+    }
+    else
+    {
+        // Names without escape sequences, which are the norm, are compared directly rather than decoded for each step.
+        struct judo_span content;
+        const bool verbatim = judo_verbatim(lexeme, length, &content);
+        int32_t wildcard = -1;
+        for (int32_t child = steps[step].child; (child >= 0) && (match < 0); child = steps[child].sibling)
+        {
+            const struct step *candidate = &steps[child];
+            const char *name = &projection->s_names[candidate->name];
+            if ((candidate->flags & STEP_WILDCARD) != 0u)
+            {
+                wildcard = child;
+            }
+            else if (verbatim ? ((content.length == candidate->length) && (memcmp(&lexeme[content.offset], name, (size_t)content.length) == 0)) : judo_nameeq(lexeme, length, name, candidate->length))
+            {
+                match = child;
+            }
+            else
+            {
+                // No action.
+            }
+        }
+
+        if (match < 0)
+        {
+            match = wildcard;
+        }
+    }
+
+    return match;
+}
+
+int32_t judo_projelement(const struct judo_projection *projection, int32_t step, judo_size index)
+{
+    const struct step *steps = steps_of(projection);
+    int32_t match = -1;
+
+    assert((step >= 0) && (step < projection->s_count)); // LCOV_EXCL_BR_LINE
+    if ((steps[step].flags & STEP_SELECTED) != 0u)
+    {
+        match = step;
+    }
+    else
+    {
+        int32_t wildcard = -1;
+        for (int32_t child = steps[step].child; (child >= 0) && (match < 0); child = steps[child].sibling)
+        {
+            if ((steps[child].flags & STEP_WILDCARD) != 0u)
+            {
+                wildcard = child;
+            }
+            else if (steps[child].index == index)
+            {
+                match = child;
+            }
+            else
+            {
+                // No action.
+            }
+        }
+
+        if (match < 0)
+        {
+            match = wildcard;
+        }
+    }
+
+    return match;
+}
+
+bool judo_projselected(const struct judo_projection *projection, int32_t step)
+{
+    assert((step >= 0) && (step < projection->s_count)); // LCOV_EXCL_BR_LINE
+    return (steps_of(projection)[step].flags & STEP_SELECTED) != 0u;
+}
+#endif
@@ -13,6 +13,7 @@
 
 #include "judo.h"
 #include "judo_utils.h"
+#include "judo_simd.h"
 
 #if defined(JUDO_HAVE_FLOATS)
 #include <math.h>
@@ -23,12 +24,6 @@
 #include <stdbool.h>
 
 #define BAD_CHARACTER_ENCODING UNICHAR_C(0x110000)
-#define INPUT_TOO_LARGE UNICHAR_C(0x110001)
-
-// Limit the maximum input size to 1 GB.
-#ifndef JUDO_MAXIMUM_INPUT_SIZE
-#define JUDO_MAXIMUM_INPUT_SIZE (int32_t)0x40000000
-#endif
 
 // Primitive JSON and JSON5 tokens.
 enum token_tag
@@ -63,19 +58,38 @@ enum token_tag
 #define SCAN_STATE_MAX_NESTING_ERROR (int8_t)10
 #define SCAN_STATE_FINISHED_PARSING (int8_t)11
 
+// Bit flags stored in the stream describing the input being scanned.
+#define STREAM_PREVALIDATED (uint8_t)0x01 // The input is known to be well-formed UTF-8.
+#define STREAM_MEASURED (uint8_t)0x02 // The length of null terminated input was computed.
+#define STREAM_RESUMABLE (uint8_t)0x04 // The string beginning at s_string can resume lexing from s_resume.
+#define STREAM_ESCAPED (uint8_t)0x08 // The resumable string has escape sequences before s_resume.
+
+// When scanning partial input, a token is only reported once the input extends at least
+// this many bytes beyond it. This guarantees the token would be scanned identically if the
+// remainder of the input were available.
+#define PUSH_LOOKAHEAD 16
+
 // Corresponds with a primitive JSON token rather than a semantic Judo token.
 struct token
 {
     enum token_tag type;
-    int32_t lexeme;
-    int32_t lexeme_length;
+    judo_size lexeme;
+    judo_size lexeme_length;
+    bool escaped; // The string or identifier has escape sequences.
+    enum judo_numtype numtype; // Classification of a number.
+    judo_size digits; // Number of digits in a number excluding its exponent.
 };
 
 struct scanner
 {
     const uint8_t *string; // Pointer to the first byte in the UTF-8 string being scanned.
-    int32_t string_length; // In UTF-8 code units.
-    int32_t index; // Scanner location as a UTF-8 byte index always aligned to a code point boundary.
+    judo_size string_length; // In UTF-8 code units.
+    judo_size index; // Scanner location as a UTF-8 byte index always aligned to a code point boundary.
+    bool trusted; // True if the string was verified to be well-formed UTF-8 ahead of time.
+    judo_size extent; // Furthest byte index examined while lexing.
+    judo_size string_start; // Index of the opening quote of an unclosed string or -1 if there's none.
+    judo_size string_resume; // Index within the unclosed string where lexing can resume.
+    bool string_escaped; // True if the unclosed string has escape sequences before where lexing resumes.
     struct judo_stream *stream;
 };
 
@@ -133,24 +147,93 @@ static inline bool judo_isxdigit(unichar codepoint)
     return is;
 }
 
-static enum judo_result bad_syntax(const struct scanner *scanner, int32_t cursor, int32_t length, const char *msg)
+// The maximum nesting depth of the stream. Zero initialized streams permit JUDO_MAXDEPTH levels.
+static inline int32_t max_depth(const struct judo_stream *stream)
+{
+    return (stream->s_depth == 0) ? JUDO_MAXDEPTH : stream->s_depth;
+}
+
+// Only the value at the top of the stack has a state of its own: the containers beneath it are
+// always waiting for the value to finish so that they can parse their next element or member.
+// Their state is therefore implied by their kind which is remembered with one bit per level.
+// The kinds of the first JUDO_MAXDEPTH levels are kept in the stream itself and the kinds of
+// deeper levels spill into the stack supplied with judo_setdepth().
+static inline uint8_t *kinds_at(struct judo_stream *stream, int32_t level)
+{
+    uint8_t *kinds;
+    if (level < JUDO_MAXDEPTH)
+    {
+        kinds = &stream->s_kinds[level / 8];
+    }
+    else
+    {
+        assert(stream->s_spill != NULL); // LCOV_EXCL_BR_LINE
+        kinds = &stream->s_spill[(level - JUDO_MAXDEPTH) / 8];
+    }
+    return kinds;
+}
+
+// Records whether the container at the top of the stack is an object or array.
+static inline void set_kind(struct judo_stream *stream, bool object)
+{
+    const int32_t level = stream->s_stack;
+    const uint8_t mask = (uint8_t)(1u << ((uint32_t)level % 8u));
+    uint8_t *kinds = kinds_at(stream, level);
+    if (object)
+    {
+        *kinds |= mask;
+    }
+    else
+    {
+        *kinds &= (uint8_t)~mask;
+    }
+}
+
+// Pops the value at the top of the stack and resumes the container beneath it.
+static inline void pop_state(struct judo_stream *stream)
+{
+    stream->s_stack -= 1;
+    const int32_t level = stream->s_stack;
+    const uint8_t mask = (uint8_t)(1u << ((uint32_t)level % 8u));
+    if ((*kinds_at(stream, level) & mask) != 0u)
+    {
+        stream->s_state = SCAN_STATE_FINISHED_PARSING_OBJECT_VALUE;
+    }
+    else
+    {
+        stream->s_state = SCAN_STATE_FINISHED_PARSING_ARRAY_ELEMENT;
+    }
+}
+
+// The state of the value at the top of the stack.
+static inline int8_t get_state(const struct judo_stream *stream)
+{
+    return stream->s_state;
+}
+
+static inline void set_state(struct judo_stream *stream, int8_t state)
+{
+    stream->s_state = state;
+}
+
+static enum judo_result bad_syntax(const struct scanner *scanner, judo_size cursor, judo_size length, const char *msg)
 {
     struct judo_stream *stream = scanner->stream;
     const size_t msglen = strlen(msg) + (size_t)1;
     assert(msglen < (size_t)JUDO_ERRMAX); // LCOV_EXCL_BR_LINE
     scanner->stream->where = (struct judo_span){cursor, length};
     scanner->stream->token = JUDO_TOKEN_INVALID;
-    scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_PARSING_ERROR;
+    set_state(scanner->stream, SCAN_STATE_PARSING_ERROR);
     (void)memcpy(stream->error, msg, msglen);
     return JUDO_RESULT_BAD_SYNTAX;
 }
 
-static enum judo_result bad_encoding(const struct scanner *scanner, int32_t cursor, int32_t length)
+static enum judo_result bad_encoding(const struct scanner *scanner, judo_size cursor, judo_size length)
 {
     struct judo_stream *stream = scanner->stream;
     scanner->stream->where = (struct judo_span){cursor, length};
     scanner->stream->token = JUDO_TOKEN_INVALID;
-    scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_ENCODING_ERROR;
+    set_state(scanner->stream, SCAN_STATE_ENCODING_ERROR);
     (void)memcpy(stream->error, "malformed encoded character", 28);
     return JUDO_RESULT_ILLEGAL_BYTE_SEQUENCE;
 }
@@ -159,7 +242,7 @@ static enum judo_result bad_input_size(struct judo_stream *stream)
 {
     stream->where = (struct judo_span){0, 0};
     stream->token = JUDO_TOKEN_INVALID;
-    stream->s_state[stream->s_stack] = SCAN_STATE_ENCODING_ERROR;
+    set_state(stream, SCAN_STATE_ENCODING_ERROR);
     (void)memcpy(stream->error, "maximum input size exceeded", 28);
     return JUDO_RESULT_INPUT_TOO_LARGE;
 }
@@ -169,47 +252,22 @@ static enum judo_result max_nesting_depth(const struct scanner *scanner)
     struct judo_stream *stream = scanner->stream;
     scanner->stream->where = (struct judo_span){scanner->index, 1};
     scanner->stream->token = JUDO_TOKEN_INVALID;
-    scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_MAX_NESTING_ERROR;
+    set_state(scanner->stream, SCAN_STATE_MAX_NESTING_ERROR);
     (void)memcpy(stream->error, "maximum nesting depth exceeded", 31);
     return JUDO_RESULT_MAXIMUM_NESTING;
 }
 
-static bool is_bounded(const uint8_t *string, int32_t length, int32_t cursor, int32_t byte_count)
+// The length of the input is always known: null terminated input is measured once by
+// judo_scan() so that bounds checks needn't probe for the null terminator.
+static inline bool is_bounded(judo_size length, judo_size cursor, judo_size byte_count)
 {
-    bool bounded = true;
-
-    if (length < 0)
-    {
-        if (cursor >= JUDO_MAXIMUM_INPUT_SIZE)
-        {
-            bounded = false;
-        }
-        else
-        {
-            for (int32_t i = 0; i < byte_count; i++)
-            {
-                if ((char)string[cursor + i] == '\0')
-                {
-                    bounded = false;
-                    break;
-                }
-            }
-        }
-    }
-    else
-    {
-        assert(length >= cursor); // LCOV_EXCL_BR_LINE
-        const int32_t remaining_bytes = length - cursor;
-        if (remaining_bytes < byte_count)
-        {
-            bounded = false;
-        }
-    }
-
-    return bounded;
+    assert(length >= cursor); // LCOV_EXCL_BR_LINE
+    return (length - cursor) >= byte_count;
 }
 
-static unichar utf8_decode(const uint8_t *string, int32_t length, int32_t cursor, int32_t *byte_count)
+// Decodes and validates one UTF-8 encoded character with a DFA. This is the reference
+// implementation which defines what Judo considers well-formed UTF-8.
+static unichar utf8_decode_sequence(const uint8_t *string, judo_size length, judo_size cursor, int32_t *byte_count)
 {
     unichar codepoint = BAD_CHARACTER_ENCODING;
     if (byte_count != NULL)
@@ -295,7 +353,7 @@ static unichar utf8_decode(const uint8_t *string, int32_t length, int32_t cursor
     const uint8_t *bytes = (const uint8_t *)&string[cursor];
 
     // Check for the END of the string.
-    if ((length >= 0) && (cursor >= length))
+    if (cursor >= length)
     {
         codepoint = UNICHAR_C('\0');
     }
@@ -305,31 +363,11 @@ static unichar utf8_decode(const uint8_t *string, int32_t length, int32_t cursor
         int32_t seqlen = (int32_t)bytes_needed_for_UTF8_sequence[bytes[0]];
 
         // Verify the sequence isn't truncated by the end of the string.
-        if (length < 0)
-        {
-            for (int32_t i = 1; i < seqlen; i++)
-            {
-                if (bytes[i] == UNICHAR_C('\0'))
-                {
-                    seqlen = 0;
-                    break;
-                }
-            }
-        }
-        else
-        {
-            assert(length >= cursor); // LCOV_EXCL_BR_LINE
-            const int32_t bytes_remaining = length - cursor;
-            if (bytes_remaining < seqlen)
-            {
-                seqlen = 0;
-            }
-        }
-
-        // Verify the input is bounded.
-        if ((cursor + seqlen) >= JUDO_MAXIMUM_INPUT_SIZE)
+        // The input length was verified to be within the maximum input size by the caller.
+        assert(length >= cursor); // LCOV_EXCL_BR_LINE
+        const judo_size bytes_remaining = length - cursor;
+        if (bytes_remaining < seqlen)
         {
-            codepoint = INPUT_TOO_LARGE;
             seqlen = 0;
         }
 
@@ -356,19 +394,11 @@ static unichar utf8_decode(const uint8_t *string, int32_t length, int32_t cursor
             // Verify the encoded character was well-formed.
             if (state == DFA_ACCEPTANCE_STATE)
             {
-                // If the string is null terminated, then substitute the null character for the special EOF character.
-                if ((length < 0) && (value == UNICHAR_C('\0')))
-                {
-                    codepoint = UNICHAR_C('\0');
-                }
-                else
+                if (byte_count != NULL)
                 {
-                    if (byte_count != NULL)
-                    {
-                        *byte_count = seqlen;
-                    }
-                    codepoint = value;
+                    *byte_count = seqlen;
                 }
+                codepoint = value;
             }
         }
     }
@@ -376,6 +406,205 @@ static unichar utf8_decode(const uint8_t *string, int32_t length, int32_t cursor
     return codepoint;
 }
 
+// Decodes one UTF-8 encoded character. The overwhelming majority of JSON is ASCII and
+// such characters are decoded inline without consulting the DFA.
+static inline unichar utf8_decode(const uint8_t *string, judo_size length, judo_size cursor, int32_t *byte_count)
+{
+    unichar codepoint;
+
+    if ((cursor < length) && (string[cursor] < (uint8_t)0x80))
+    {
+        if (byte_count != NULL)
+        {
+            *byte_count = 1;
+        }
+        codepoint = (unichar)string[cursor];
+    }
+    else
+    {
+        codepoint = utf8_decode_sequence(string, length, cursor, byte_count);
+    }
+
+    return codepoint;
+}
+
+#if defined(JUDO_SIMD_LOOKUP)
+// Flags for the vectorized UTF-8 validation algorithm. Each flag describes an error
+// condition detectable from the high and low nibbles of two consecutive bytes. A pair
+// of bytes is malformed if the flags looked up for all three nibbles have a bit in common.
+#define UTF8_TOO_SHORT (uint8_t)0x01 // 11______ 0_______ or 11______ 11______
+#define UTF8_TOO_LONG (uint8_t)0x02 // 0_______ 10______
+#define UTF8_OVERLONG_3 (uint8_t)0x04 // 11100000 100_____
+#define UTF8_TOO_LARGE (uint8_t)0x08 // 11110100 1001____ or 11110100 101_____ or 11110101+ 10______
+#define UTF8_SURROGATE (uint8_t)0x10 // 11101101 101_____
+#define UTF8_OVERLONG_2 (uint8_t)0x20 // 1100000_ 10______
+#define UTF8_TOO_LARGE_1000 (uint8_t)0x40 // 11110101+ 1000____
+#define UTF8_OVERLONG_4 (uint8_t)0x40 // 11110000 1000____
+#define UTF8_TWO_CONTS (uint8_t)0x80 // 10______ 10______
+#define UTF8_CARRY (uint8_t)(UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+// Validates a block of bytes given the previous block. Returns a non-zero vector if
+// the block contains a malformed sequence.
+static inline simd_block utf8_check_block(simd_block input, simd_block prev_input)
+{
+    static const uint8_t byte_1_high[16] = {
+        // 0_______ ________ (ASCII in byte 1)
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        // 10______ ________ (continuation in byte 1)
+        UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+        // 1100____ ________ (two byte lead in byte 1)
+        UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+        // 1101____ ________ (two byte lead in byte 1)
+        UTF8_TOO_SHORT,
+        // 1110____ ________ (three byte lead in byte 1)
+        UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+        // 1111____ ________ (four+ byte lead in byte 1)
+        UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+    };
+
+    static const uint8_t byte_1_low[16] = {
+        // ____0000 ________
+        UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+        // ____0001 ________
+        UTF8_CARRY | UTF8_OVERLONG_2,
+        // ____001_ ________
+        UTF8_CARRY,
+        UTF8_CARRY,
+        // ____0100 ________
+        UTF8_CARRY | UTF8_TOO_LARGE,
+        // ____0101 ________
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        // ____011_ ________
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        // ____1___ ________
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        // ____1101 ________
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    };
+
+    static const uint8_t byte_2_high[16] = {
+        // ________ 0_______ (ASCII in byte 2)
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        // ________ 1000____
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+        // ________ 1001____
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+        // ________ 101_____
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+        // ________ 11______
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    };
+
+    // Errors detectable from a pair of bytes.
+    const simd_block prev1 = simd_prev1(input, prev_input);
+    const simd_block special_cases = simd_and(
+        simd_and(simd_lookup(simd_table(byte_1_high), simd_high_nibbles(prev1)),
+                 simd_lookup(simd_table(byte_1_low), simd_low_nibbles(prev1))),
+        simd_lookup(simd_table(byte_2_high), simd_high_nibbles(input)));
+
+    // The third and fourth bytes of a three and four byte sequence must be continuation bytes.
+    // The high bit is set for bytes which must be continuations and XOR'd with the pairwise
+    // errors which flagged continuation bytes as TWO_CONTS.
+    const simd_block is_third_byte = simd_subs(simd_prev2(input, prev_input), simd_splat((uint8_t)(0xE0u - 0x80u)));
+    const simd_block is_fourth_byte = simd_subs(simd_prev3(input, prev_input), simd_splat((uint8_t)(0xF0u - 0x80u)));
+    const simd_block must_be_continuation = simd_and(simd_or(is_third_byte, is_fourth_byte), simd_splat((uint8_t)0x80));
+    return simd_xor(must_be_continuation, special_cases);
+}
+
+// Returns a non-zero vector if the block ends with an incomplete sequence.
+static inline simd_block utf8_check_incomplete(simd_block input)
+{
+    static const uint8_t max_value[32] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+    };
+    return simd_subs(input, simd_load(&max_value[32 - JUDO_SIMD_WIDTH]));
+}
+#endif
+
+// Verifies the input is well-formed UTF-8 without decoding it. This must accept exactly
+// the inputs that utf8_decode_sequence() accepts. When a byte shuffle instruction is
+// available, the input is validated a block at a time with a table-driven algorithm that
+// classifies malformed sequences by the nibbles of adjacent bytes. Otherwise it falls back
+// on the DFA for non-ASCII characters.
+static bool utf8_validate(const uint8_t *string, judo_size length)
+{
+    bool valid = true;
+    judo_size index = 0;
+
+#if defined(JUDO_SIMD_LOOKUP)
+    simd_block error = simd_zero();
+    simd_block prev_input = simd_zero();
+    simd_block prev_incomplete = simd_zero();
+
+    while (index < length)
+    {
+        simd_block input;
+        if ((length - index) >= JUDO_SIMD_WIDTH)
+        {
+            input = simd_load(&string[index]);
+        }
+        else
+        {
+            // Pad the final block with ASCII so truncated sequences are reported as too short.
+            uint8_t padded[JUDO_SIMD_WIDTH];
+            (void)memset(padded, 0x20, sizeof(padded));
+            (void)memcpy(padded, &string[index], (size_t)(length - index));
+            input = simd_load(padded);
+        }
+
+        if (simd_nonascii(input) == 0u)
+        {
+            // An ASCII block is only malformed if the previous block ended mid-sequence.
+            error = simd_or(error, prev_incomplete);
+        }
+        else
+        {
+            error = simd_or(error, utf8_check_block(input, prev_input));
+            prev_incomplete = utf8_check_incomplete(input);
+        }
+
+        prev_input = input;
+        index += JUDO_SIMD_WIDTH;
+    }
+
+    error = simd_or(error, prev_incomplete);
+    valid = !simd_any(error);
+#else
+    while (valid && (index < length))
+    {
+        if (string[index] < (uint8_t)0x80)
+        {
+            index += 1;
+        }
+        else
+        {
+            int32_t byte_count = 0;
+            const unichar codepoint = utf8_decode_sequence(string, length, index, &byte_count);
+            if (codepoint == BAD_CHARACTER_ENCODING)
+            {
+                valid = false;
+            }
+            index += byte_count;
+        }
+    }
+#endif
+
+    return valid;
+}
+
 static int32_t utf8_encode(unichar codepoint, char bytes[4])
 {
     uint8_t *data = (uint8_t *)bytes;
@@ -413,7 +642,7 @@ static int32_t utf8_encode(unichar codepoint, char bytes[4])
 static unichar parse_character(const char *string)
 {
     unichar codepoint = UNICHAR_C(0x0);
-    int32_t index = 0;
+    judo_size index = 0;
 
     // Parse hexadecimal digits.
     while (string[index] != '\0')
@@ -444,10 +673,10 @@ static unichar parse_character(const char *string)
     return codepoint;
 }
 
-static bool is_match(const uint8_t *string, const char *prefix, int32_t string_length)
+static bool is_match(const uint8_t *string, const char *prefix, judo_size string_length)
 {
     bool match = true;
-    int32_t index = 0;
+    judo_size index = 0;
 
     while ((index < string_length) && (prefix[index] != '\0'))
     {
@@ -475,12 +704,12 @@ static bool is_match(const uint8_t *string, const char *prefix, int32_t string_l
 #if defined(JUDO_HAVE_FLOATS)
 #if defined(JUDO_JSON5)
 // This atol() implementation exclusively parses hexidecimal numbers.
-static enum judo_result json_atol(const char *string, int32_t string_length, judo_number *number)
+static enum judo_result json_atol(const char *string, judo_size string_length, judo_number *number)
 {
     enum judo_result result;
     judo_number value = (judo_number)0.0;
     judo_number sign = (judo_number)1.0;
-    int32_t index = 0;
+    judo_size index = 0;
     char c;
 
     // Parse sign.
@@ -544,137 +773,7 @@ static enum judo_result json_atol(const char *string, int32_t string_length, jud
 }
 #endif
 
-// Locale independent atof() implementation.
-static enum judo_result json_atof(const char *string, int32_t string_length, judo_number *number)
-{
-    enum judo_result result;
-    judo_number value = (judo_number)0.0;
-    judo_number sign = (judo_number)1.0;
-    int32_t exponent = 0;
-    int32_t index = 0;
-    char codepoint = '\0';
-
-#if defined(JUDO_JSON5)
-    // Parse sign.
-    if (string[index] == '+')
-    {
-        index += 1;
-    }
-    else
-#endif
-    {
-        if (string[index] == '-')
-        {
-            sign = (judo_number)-1.0;
-            index += 1;
-        }
-    }
-
-    // Parse whole numbers.
-    while (index < string_length)
-    {
-        codepoint = string[index];
-        index += 1;
-
-        if (!judo_isdigit((unichar)codepoint))
-        {
-            break;
-        }
-
-        const char c = codepoint - '0';
-        const int32_t n = (int32_t)c;
-        value = (value * (judo_number)10.0) + (judo_number)n;
-    }
-
-    // Parse the fractional part.
-    if (codepoint == '.')
-    {
-        while (index < string_length)
-        {
-            codepoint = string[index];
-            index += 1;
-
-            if (!judo_isdigit((unichar)codepoint))
-            {
-                break;
-            }
-
-            const char c = codepoint - '0';
-            const int32_t n = (int32_t)c;
-            value = (value * (judo_number)10.0) + (judo_number)n;
-            exponent = exponent - 1;
-        }
-    }
-
-    // Parse scientific notation.
-    if ((codepoint == 'e') || (codepoint == 'E'))
-    {
-        int32_t exp_sign = 1;
-        int32_t exp_value = 0;
-
-        while (index < string_length)
-        {
-            codepoint = string[index];
-            index += 1;
-
-            if (codepoint == '+')
-            {
-                codepoint = string[index];
-                index += 1;
-            }
-            else
-            {
-                if (codepoint == '-')
-                {
-                    codepoint = string[index];
-                    index += 1;
-                    exp_sign = -1;
-                }
-            }
-
-            for (;;)
-            {
-                const char c = codepoint - '0';
-                const int32_t n = (int32_t)c;
-                exp_value = (exp_value * 10) + (int32_t)n;
-                if (index >= string_length)
-                {
-                    break;
-                }
-                codepoint = string[index];
-                index += 1;
-            }
-        }
-
-        exponent += exp_value * exp_sign;
-    }
-
-    while (exponent > 0)
-    {
-        value *= (judo_number)10.0;
-        exponent--;
-    }
-
-    while (exponent < 0)
-    {
-        value *= (judo_number)0.1;
-        exponent++;
-    }
-
-    if (value == (judo_number)INFINITY)
-    {
-        result = JUDO_RESULT_OUT_OF_RANGE;
-    }
-    else
-    {
-        result = JUDO_RESULT_SUCCESS;
-    }
-
-    *number = value * sign;
-    return result;
-}
-
-enum judo_result judo_numberify(const char *lexeme, int32_t length, judo_number *number) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+enum judo_result judo_numberify(const char *lexeme, judo_size length, judo_number *number) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
 {
     const uint8_t *bytes = (const uint8_t *)lexeme;
     enum judo_result result = JUDO_RESULT_SUCCESS;
@@ -694,8 +793,8 @@ enum judo_result judo_numberify(const char *lexeme, int32_t length, judo_number
     else
     {
         judo_number sign = (judo_number)1.0;
-        int32_t ident = 0;
-        int32_t ident_length = length;
+        judo_size ident = 0;
+        judo_size ident_length = length;
         if (lexeme[ident] == '-')
         {
             sign = (judo_number)-1.0;
@@ -718,7 +817,7 @@ enum judo_result judo_numberify(const char *lexeme, int32_t length, judo_number
         {
             *number = (judo_number)NAN;
         }
-        else if (is_match(&bytes[ident], "Infinite", ident_length))
+        else if (is_match(&bytes[ident], "Infinity", ident_length))
         {
             *number = sign * (judo_number)INFINITY;
         }
@@ -730,7 +829,7 @@ enum judo_result judo_numberify(const char *lexeme, int32_t length, judo_number
         else
 #endif
         {
-            result = json_atof(lexeme, length, number);
+            result = judo_atof(lexeme, length, number);
         }
     }
 
@@ -738,30 +837,458 @@ enum judo_result judo_numberify(const char *lexeme, int32_t length, judo_number
 }
 #endif
 
-#if defined(JUDO_JSON5) || defined(JUDO_WITH_COMMENTS)
-static int32_t is_newline(const uint8_t *string, int32_t length, int32_t cursor)
+// Integers beneath this are multiplied by 10^8 and added to eight digits without overflow.
+#define EIGHT_DIGITS_LIMIT UINT64_C(100000000000)
+
+// Integers beneath this are multiplied by ten and added to a digit without overflow.
+#define NINETEEN_DIGITS_MIN UINT64_C(1000000000000000000)
+
+// Loads eight bytes so the first byte is least significant regardless of the host byte order.
+static uint64_t load_eight_bytes(const uint8_t *bytes)
 {
-    int32_t byte_count = 0;
-    
-    if (is_bounded(string, length, cursor, 2))
+    uint64_t chunk = 0;
+    for (int32_t i = 7; i >= 0; i--)
     {
-        if (is_match(&string[cursor], "\r\n", 2))
+        chunk = (chunk << 8u) | (uint64_t)bytes[i];
+    }
+    return chunk;
+}
+
+// Checks if all eight bytes are ASCII digits by verifying each byte and each byte plus six
+// has 0x3 as its high nibble.
+static bool is_eight_digits(uint64_t chunk)
+{
+    const uint64_t high_nibbles = UINT64_C(0xF0F0F0F0F0F0F0F0);
+    const uint64_t sum = chunk + UINT64_C(0x0606060606060606);
+    return ((chunk & high_nibbles) | ((sum & high_nibbles) >> 4u)) == UINT64_C(0x3333333333333333);
+}
+
+// Converts eight ASCII digits to their value by combining adjacent digits, then adjacent
+// pairs, then adjacent quads in parallel within the 64-bit integer.
+static uint32_t parse_eight_digits(uint64_t chunk)
+{
+    uint64_t value = chunk & UINT64_C(0x0F0F0F0F0F0F0F0F);
+    value = (value * 10u) + (value >> 8u);
+    value = (((value & UINT64_C(0x000000FF000000FF)) * UINT64_C(0x000F424000000064)) +
+             (((value >> 16u) & UINT64_C(0x000000FF000000FF)) * UINT64_C(0x0000271000000001))) >> 32u;
+    return (uint32_t)value;
+}
+
+// Accumulates the run of decimal digits at 'index' into 'value' and advances the index past
+// them. Returns false if the value overflows in which case the remaining digits are skipped.
+static bool accumulate_digits(const uint8_t *bytes, judo_size length, judo_size *index, uint64_t *value)
+{
+    uint64_t accumulator = *value;
+    judo_size at = *index;
+    bool fits = true;
+
+    while ((accumulator < EIGHT_DIGITS_LIMIT) && ((length - at) >= 8))
+    {
+        const uint64_t chunk = load_eight_bytes(&bytes[at]);
+        if (!is_eight_digits(chunk))
         {
-            byte_count = 2;
+            break;
         }
+        accumulator = (accumulator * UINT64_C(100000000)) + parse_eight_digits(chunk);
+        at += 8;
     }
 
-    if (byte_count == 0)
+    while ((at < length) && judo_isdigit((unichar)bytes[at]))
     {
-        if (is_bounded(string, length, cursor, 1))
+        const uint64_t digit = (uint64_t)bytes[at] - (uint64_t)'0';
+        if (!fits)
         {
-            switch (utf8_decode(string, length, cursor, &byte_count))
-            {
-            case 0x000A: // Line feed
-            case 0x000D: // Carriage return
-            case 0x2028: // Line separator
-            case 0x2029: // Paragraph separator
-                break;
+            // No action.
+        }
+        else if ((accumulator >= NINETEEN_DIGITS_MIN) && (accumulator > ((UINT64_MAX - digit) / 10u)))
+        {
+            fits = false;
+        }
+        else
+        {
+            accumulator = (accumulator * 10u) + digit;
+        }
+        at += 1;
+    }
+
+    *value = accumulator;
+    *index = at;
+    return fits;
+}
+
+#if defined(JUDO_JSON5)
+static enum judo_result hex_to_integer(const uint8_t *bytes, judo_size length, judo_size index, uint64_t *magnitude)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    uint64_t value = 0;
+
+    for (judo_size at = index; at < length; at++)
+    {
+        const uint8_t c = bytes[at];
+        uint64_t digit;
+
+        if (c <= (uint8_t)'9')
+        {
+            digit = (uint64_t)c - (uint64_t)'0';
+        }
+        else if (c <= (uint8_t)'F')
+        {
+            digit = ((uint64_t)c - (uint64_t)'A') + 10u;
+        }
+        else
+        {
+            digit = ((uint64_t)c - (uint64_t)'a') + 10u;
+        }
+
+        if (value > (UINT64_MAX >> 4u))
+        {
+            result = JUDO_RESULT_OUT_OF_RANGE;
+            break;
+        }
+        value = (value << 4u) | digit;
+    }
+
+    *magnitude = value;
+    return result;
+}
+#endif
+
+// Converts a number with a fraction or exponent. It's an integer if its digits, without the
+// trailing zeros, are scaled by a non-negative power of ten.
+static enum judo_result scientific_to_integer(const uint8_t *bytes, judo_size length, judo_size index, uint64_t *magnitude)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    const judo_size integer_begin = index;
+    judo_size at = index;
+    int64_t exponent = 0;
+
+    while ((at < length) && judo_isdigit((unichar)bytes[at]))
+    {
+        at += 1;
+    }
+
+    const judo_size integer_end = at;
+    judo_size fraction_begin = at;
+    judo_size fraction_end = at;
+    if ((at < length) && (bytes[at] == (uint8_t)'.'))
+    {
+        at += 1;
+        fraction_begin = at;
+        while ((at < length) && judo_isdigit((unichar)bytes[at]))
+        {
+            at += 1;
+        }
+        fraction_end = at;
+    }
+
+    if ((at < length) && ((bytes[at] == (uint8_t)'e') || (bytes[at] == (uint8_t)'E')))
+    {
+        bool negative = false;
+        at += 1;
+        if (bytes[at] == (uint8_t)'-')
+        {
+            negative = true;
+            at += 1;
+        }
+        else if (bytes[at] == (uint8_t)'+')
+        {
+            at += 1;
+        }
+        else
+        {
+            // No action.
+        }
+
+        // Exponents this large overflow regardless so they're clamped.
+        while (at < length)
+        {
+            if (exponent < 0x10000000)
+            {
+                exponent = (exponent * 10) + ((int64_t)bytes[at] - (int64_t)'0');
+            }
+            at += 1;
+        }
+
+        if (negative)
+        {
+            exponent = -exponent;
+        }
+    }
+
+    // Find the first and last nonzero digits. The digits are the integer part followed by the
+    // fractional part, so the fractional part is searched last to first and vice versa.
+    judo_size first = -1;
+    judo_size last = -1;
+    for (judo_size i = integer_begin; (i < integer_end) && (first < 0); i++)
+    {
+        if (bytes[i] != (uint8_t)'0')
+        {
+            first = i;
+        }
+    }
+    for (judo_size i = fraction_begin; (i < fraction_end) && (first < 0); i++)
+    {
+        if (bytes[i] != (uint8_t)'0')
+        {
+            first = i;
+        }
+    }
+    for (judo_size i = fraction_end - 1; (i >= fraction_begin) && (last < 0); i--)
+    {
+        if (bytes[i] != (uint8_t)'0')
+        {
+            last = i;
+        }
+    }
+    for (judo_size i = integer_end - 1; (i >= integer_begin) && (last < 0); i--)
+    {
+        if (bytes[i] != (uint8_t)'0')
+        {
+            last = i;
+        }
+    }
+
+    if (first < 0)
+    {
+        *magnitude = 0;
+    }
+    else
+    {
+        // The power of ten applied to the last nonzero digit and the number of significant digits.
+        int64_t scale = exponent;
+        judo_size digits = (last - first) + 1;
+        if (last >= fraction_begin)
+        {
+            scale -= (int64_t)(last - fraction_begin) + 1;
+        }
+        else
+        {
+            scale += (int64_t)(integer_end - last) - 1;
+        }
+
+        if ((first < integer_end) && (last >= fraction_begin))
+        {
+            digits -= 1; // Exclude the decimal point.
+        }
+
+        if (scale < 0)
+        {
+            result = JUDO_RESULT_OUT_OF_RANGE; // The number has a fractional part.
+        }
+        else if (((int64_t)digits + scale) > 20)
+        {
+            result = JUDO_RESULT_OUT_OF_RANGE; // The number is at least 10^20.
+        }
+        else
+        {
+            uint64_t value = 0;
+            for (judo_size i = first; i <= last; i++)
+            {
+                if (bytes[i] != (uint8_t)'.')
+                {
+                    const uint64_t digit = (uint64_t)bytes[i] - (uint64_t)'0';
+                    if (value > ((UINT64_MAX - digit) / 10u))
+                    {
+                        result = JUDO_RESULT_OUT_OF_RANGE;
+                        break;
+                    }
+                    value = (value * 10u) + digit;
+                }
+            }
+
+            for (int64_t i = 0; (i < scale) && (result == JUDO_RESULT_SUCCESS); i++)
+            {
+                if (value > (UINT64_MAX / 10u))
+                {
+                    result = JUDO_RESULT_OUT_OF_RANGE;
+                }
+                else
+                {
+                    value *= 10u;
+                }
+            }
+
+            *magnitude = value;
+        }
+    }
+
+    return result;
+}
+
+// Converts the lexeme of a number to its sign and magnitude if it's an integer that fits in 64 bits.
+static enum judo_result lexeme_to_integer(const char *lexeme, judo_size length, uint64_t *magnitude, bool *negative)
+{
+    const uint8_t *bytes = (const uint8_t *)lexeme;
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    judo_size index = 0;
+
+    *negative = false;
+    if (bytes[index] == (uint8_t)'-')
+    {
+        *negative = true;
+        index += 1;
+    }
+#if defined(JUDO_JSON5)
+    else if (bytes[index] == (uint8_t)'+')
+    {
+        index += 1;
+    }
+#endif
+    else
+    {
+        // No action.
+    }
+
+#if defined(JUDO_JSON5)
+    if (is_match(&bytes[index], "NaN", length - index) ||
+        is_match(&bytes[index], "Infinity", length - index))
+    {
+        result = JUDO_RESULT_OUT_OF_RANGE;
+    }
+    else if (((length - index) > 2) && (bytes[index] == (uint8_t)'0') &&
+             ((bytes[index + 1] == (uint8_t)'x') || (bytes[index + 1] == (uint8_t)'X')))
+    {
+        result = hex_to_integer(bytes, length, index + 2, magnitude);
+    }
+    else
+#endif
+    {
+        // Most integers have no fraction or exponent so convert them directly.
+        uint64_t value = 0;
+        judo_size at = index;
+        const bool fits = accumulate_digits(bytes, length, &at, &value);
+        if (at < length)
+        {
+            result = scientific_to_integer(bytes, length, index, magnitude);
+        }
+        else if (!fits)
+        {
+            result = JUDO_RESULT_OUT_OF_RANGE;
+        }
+        else
+        {
+            *magnitude = value;
+        }
+    }
+
+    return result;
+}
+
+enum judo_result judo_integerify(const char *lexeme, judo_size length, int64_t *integer) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+
+    if (lexeme == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (length <= 0)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (integer == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        uint64_t magnitude = 0;
+        bool negative = false;
+        result = lexeme_to_integer(lexeme, length, &magnitude, &negative);
+        if (result == JUDO_RESULT_SUCCESS)
+        {
+            const uint64_t limit = (uint64_t)INT64_MAX;
+            if (!negative)
+            {
+                if (magnitude > limit)
+                {
+                    result = JUDO_RESULT_OUT_OF_RANGE;
+                }
+                else
+                {
+                    *integer = (int64_t)magnitude;
+                }
+            }
+            else if (magnitude > (limit + 1u))
+            {
+                result = JUDO_RESULT_OUT_OF_RANGE;
+            }
+            else if (magnitude == (limit + 1u))
+            {
+                *integer = INT64_MIN;
+            }
+            else
+            {
+                *integer = -(int64_t)magnitude;
+            }
+        }
+    }
+
+    return result;
+}
+
+enum judo_result judo_uintegerify(const char *lexeme, judo_size length, uint64_t *integer) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+
+    if (lexeme == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (length <= 0)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (integer == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        uint64_t magnitude = 0;
+        bool negative = false;
+        result = lexeme_to_integer(lexeme, length, &magnitude, &negative);
+        if (result == JUDO_RESULT_SUCCESS)
+        {
+            // Negative zero is zero.
+            if (negative && (magnitude != 0u))
+            {
+                result = JUDO_RESULT_OUT_OF_RANGE;
+            }
+            else
+            {
+                *integer = magnitude;
+            }
+        }
+    }
+
+    return result;
+}
+
+#if defined(JUDO_JSON5) || defined(JUDO_WITH_COMMENTS)
+static int32_t is_newline(const uint8_t *string, judo_size length, judo_size cursor)
+{
+    int32_t byte_count = 0;
+    
+    if (is_bounded(length, cursor, 2))
+    {
+        if (is_match(&string[cursor], "\r\n", 2))
+        {
+            byte_count = 2;
+        }
+    }
+
+    if (byte_count == 0)
+    {
+        if (is_bounded(length, cursor, 1))
+        {
+            switch (utf8_decode(string, length, cursor, &byte_count))
+            {
+            case 0x000A: // Line feed
+            case 0x000D: // Carriage return
+            case 0x2028: // Line separator
+            case 0x2029: // Paragraph separator
+                break;
             default:
                 byte_count = 0;
                 break;
@@ -777,7 +1304,7 @@ static int32_t is_newline(const uint8_t *string, int32_t length, int32_t cursor)
 static enum judo_result scan_number(const struct scanner *scanner, struct token *token)
 {
     enum judo_result result = JUDO_RESULT_SUCCESS;
-    int32_t index = scanner->index;
+    judo_size index = scanner->index;
     unichar sign = UNICHAR_C(0);
     bool has_decimal = false;
     unichar codepoint = scanner->string[index];
@@ -801,7 +1328,7 @@ static enum judo_result scan_number(const struct scanner *scanner, struct token
     codepoint = utf8_decode(scanner->string, scanner->string_length, index, NULL);
     if (judo_isdigit(codepoint))
     {
-        if (is_bounded(scanner->string, scanner->string_length, index, 2))
+        if (is_bounded(scanner->string_length, index, 2))
         {
             // Special case: JSON5 allows hexadecimal numbers.
             if (is_match(&scanner->string[index], "0x", 2) ||
@@ -815,6 +1342,7 @@ static enum judo_result scan_number(const struct scanner *scanner, struct token
                     result = bad_syntax(scanner, index, 1, "expected hexadecimal number");
                 }
 
+                const judo_size hex_start = index;
                 for (;;)
                 {
                     codepoint = utf8_decode(scanner->string, scanner->string_length, index, NULL);
@@ -826,7 +1354,9 @@ static enum judo_result scan_number(const struct scanner *scanner, struct token
                 }
 
                 token->type = TOKEN_NUMBER;
-                token->lexeme_length = (int32_t)(index - scanner->index);
+                token->numtype = JUDO_NUMTYPE_HEX;
+                token->digits = index - hex_start;
+                token->lexeme_length = (judo_size)(index - scanner->index);
             }
         }
 
@@ -837,7 +1367,7 @@ static enum judo_result scan_number(const struct scanner *scanner, struct token
 
             // We've now read in one digit.
             const unichar first_digit = codepoint;
-            int32_t digit_count = 1;
+            judo_size digit_count = 1;
 
             // Consume remaining integer digits.
             for (;;)
@@ -857,9 +1387,9 @@ static enum judo_result scan_number(const struct scanner *scanner, struct token
             }
         }
     }
-    else if (judo_isalpha(codepoint)) // Special case: JSON5 allows NaN and Infinite.
+    else if (judo_isalpha(codepoint)) // Special case: JSON5 allows NaN and Infinity.
     {
-        int32_t id_start = index;
+        judo_size id_start = index;
         for (;;)
         {
             codepoint = utf8_decode(scanner->string, scanner->string_length, index, NULL);
@@ -870,15 +1400,16 @@ static enum judo_result scan_number(const struct scanner *scanner, struct token
             index += 1;
         }
 
-        const int32_t id_length = index - id_start;
+        const judo_size id_length = index - id_start;
         if (!is_match(&scanner->string[id_start], "NaN", id_length) &&
-            !is_match(&scanner->string[id_start], "Infinite", id_length))
+            !is_match(&scanner->string[id_start], "Infinity", id_length))
         {
-            result = bad_syntax(scanner, id_start, id_length, "expected NaN or Infinite");
+            result = bad_syntax(scanner, id_start, id_length, "expected NaN or Infinity");
         }
 
         token->type = TOKEN_NUMBER;
-        token->lexeme_length = (int32_t)(index - scanner->index);
+        token->numtype = JUDO_NUMTYPE_SPECIAL;
+        token->lexeme_length = (judo_size)(index - scanner->index);
     }
     else
     {
@@ -907,7 +1438,7 @@ static enum judo_result scan_number(const struct scanner *scanner, struct token
 
         // JSON5 allows numbers to begin and end with a trailing decimal point.
         // Make sure a number was parsed and we didn't just receive a sign or decimal point by themselves.
-        int32_t digit_count = index - scanner->index;
+        judo_size digit_count = index - scanner->index;
         if (sign != UNICHAR_C(0))
         {
             digit_count -= 1; // One of the characters is a sign.
@@ -921,9 +1452,14 @@ static enum judo_result scan_number(const struct scanner *scanner, struct token
             result = bad_syntax(scanner, index, 1, "expected number");
         }
 
+        // The number is a decimal if it has a fraction or exponent.
+        token->numtype = has_decimal ? JUDO_NUMTYPE_DECIMAL : JUDO_NUMTYPE_INTEGER;
+        token->digits = digit_count;
+
         // ['e' | 'E']
         if ((codepoint == UNICHAR_C('e')) || (codepoint == UNICHAR_C('E')))
         {
+            token->numtype = JUDO_NUMTYPE_DECIMAL;
             index++; // Consume 'e'.
             codepoint = utf8_decode(scanner->string, scanner->string_length, index, NULL);
 
@@ -955,7 +1491,7 @@ static enum judo_result scan_number(const struct scanner *scanner, struct token
         if (result == JUDO_RESULT_SUCCESS)
         {
             token->type = TOKEN_NUMBER;
-            token->lexeme_length = (int32_t)(index - scanner->index);
+            token->lexeme_length = (judo_size)(index - scanner->index);
         }
     }
 
@@ -965,7 +1501,7 @@ static enum judo_result scan_number(const struct scanner *scanner, struct token
 static enum judo_result scan_number(const struct scanner *scanner, struct token *token)
 {
     enum judo_result result = JUDO_RESULT_SUCCESS;
-    int32_t index = scanner->index;
+    judo_size index = scanner->index;
     unichar codepoint = scanner->string[index];
 
     // Consume the sign.
@@ -987,7 +1523,7 @@ static enum judo_result scan_number(const struct scanner *scanner, struct token
 
         // We've now read in one digit.
         const unichar first_digit = codepoint;
-        int32_t digits = 1;
+        judo_size digits = 1;
 
         // Consume remaining integer digits.
         for (;;)
@@ -1007,9 +1543,13 @@ static enum judo_result scan_number(const struct scanner *scanner, struct token
         }
         else
         {
+            token->numtype = JUDO_NUMTYPE_INTEGER;
+            token->digits = digits;
+
             // '.'
             if (codepoint == UNICHAR_C('.'))
             {
+                token->numtype = JUDO_NUMTYPE_DECIMAL;
                 index++; // Consume '.'
 
                 // Consume remaining digits.
@@ -1030,11 +1570,13 @@ static enum judo_result scan_number(const struct scanner *scanner, struct token
                 {
                     result = bad_syntax(scanner, scanner->index, index - scanner->index, "expected fractional part");
                 }
+                token->digits += digits;
             }
 
             // ['e' | 'E']
             if ((codepoint == UNICHAR_C('e')) || (codepoint == UNICHAR_C('E')))
             {
+                token->numtype = JUDO_NUMTYPE_DECIMAL;
                 index++; // Consume 'e'.
                 codepoint = utf8_decode(scanner->string, scanner->string_length, index, NULL);
 
@@ -1066,7 +1608,7 @@ static enum judo_result scan_number(const struct scanner *scanner, struct token
             if (result == JUDO_RESULT_SUCCESS)
             {
                 token->type = TOKEN_NUMBER;
-                token->lexeme_length = (int32_t)(index - scanner->index);
+                token->lexeme_length = (judo_size)(index - scanner->index);
             }
         }
     }
@@ -1075,31 +1617,95 @@ static enum judo_result scan_number(const struct scanner *scanner, struct token
 }
 #endif
 
-static enum judo_result scan_string(const struct scanner *scanner, struct token *token)
+// Skips ASCII characters in the body of a string up to, but excluding, the next closing quote,
+// backslash, control character, or non-ASCII byte. Strings typically consist of long runs of
+// such characters so, when possible, they're skipped a block at a time. If the input is trusted
+// to be well-formed UTF-8, then non-ASCII bytes are skipped too since they needn't be decoded.
+static judo_size skip_string_text(const uint8_t *string, judo_size length, judo_size cursor, uint8_t quote_char, bool trusted)
 {
-    enum judo_result result = JUDO_RESULT_SUCCESS;
-    const uint8_t *string = scanner->string;
-    const uint8_t quote_char = scanner->string[scanner->index];
-    int32_t index = scanner->index;
-    unichar codepoint;
+    const uint8_t max_byte = trusted ? (uint8_t)0xFF : (uint8_t)0x7F;
+    judo_size index = cursor;
+    judo_size stop = length;
 
-    index += 1; // consume opening quote
-    
-    // Loop until the closing quote is encountered or EOF.
-    while (is_bounded(string, scanner->string_length, index, 1) && (result == JUDO_RESULT_SUCCESS))
+#if defined(JUDO_SIMD_WIDTH)
+    while ((stop - index) >= JUDO_SIMD_WIDTH)
     {
-        // Check for characters that MUST be escaped.
-        if (string[index] <= (uint8_t)0x001F)
+        const simd_block block = simd_load(&string[index]);
+        uint32_t special = simd_eq(block, quote_char) |
+                           simd_eq(block, (uint8_t)0x5C) |
+                           simd_le(block, (uint8_t)0x1F);
+        if (!trusted)
+        {
+            special |= simd_nonascii(block);
+        }
+        if (special != 0u)
+        {
+            index += judo_ctz(special);
+            stop = index; // Found the first byte needing attention.
+            break;
+        }
+        index += JUDO_SIMD_WIDTH;
+    }
+#endif
+
+    while (index < stop)
+    {
+        const uint8_t byte = string[index];
+        if ((byte <= (uint8_t)0x1F) || (byte > max_byte) || (byte == (uint8_t)0x5C) || (byte == quote_char))
+        {
+            break;
+        }
+        index += 1;
+    }
+
+    return index;
+}
+
+static enum judo_result scan_string(struct scanner *scanner, struct token *token)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    const uint8_t *string = scanner->string;
+    const uint8_t quote_char = scanner->string[scanner->index];
+    judo_size index = scanner->index;
+    unichar codepoint;
+
+    index += 1; // consume opening quote
+
+    // If this string was left unclosed by a previous window, then resume where it left off.
+    if (scanner->string_start == scanner->index)
+    {
+        index = scanner->string_resume;
+        token->escaped = scanner->string_escaped;
+    }
+
+    // Characters before 'resume' were lexed without examining anything past the end of the input
+    // so lexing can resume there once more input is available.
+    judo_size resume = index;
+    bool resume_escaped = token->escaped;
+    
+    // Loop until the closing quote is encountered or EOF.
+    while (is_bounded(scanner->string_length, index, 1) && (result == JUDO_RESULT_SUCCESS))
+    {
+        // The longest escape sequence examines fewer than PUSH_LOOKAHEAD bytes.
+        if ((scanner->string_length - index) >= PUSH_LOOKAHEAD)
+        {
+            resume = index;
+            resume_escaped = token->escaped;
+        }
+
+        // Check for characters that MUST be escaped.
+        if (string[index] <= (uint8_t)0x001F)
         {
             result = bad_syntax(scanner, index, 1, "unescaped control character");
         }
         // Check for escape sequence.
         else if (string[index] == (uint8_t)0x5C)
         {
-            const int32_t escape_start = index;
+            const judo_size escape_start = index;
+            token->escaped = true;
             index += 1; // consume backslash
 
-            if (is_bounded(string, scanner->string_length, index, 1))
+            if (is_bounded(scanner->string_length, index, 1))
             {
                 int32_t byte_count;
 
@@ -1132,7 +1738,7 @@ static enum judo_result scan_string(const struct scanner *scanner, struct token
 #if defined(JUDO_JSON5)
                 case 'x':
                     index += 1; // consume 'x'
-                    while (is_bounded(string, scanner->string_length, index, 1))
+                    while (is_bounded(scanner->string_length, index, 1))
                     {
                         if ((digit_count == 2) || !judo_isxdigit(string[index]))
                         {
@@ -1150,7 +1756,7 @@ static enum judo_result scan_string(const struct scanner *scanner, struct token
 
                 case 'u':
                     index += 1; // consume 'u'
-                    while (is_bounded(string, scanner->string_length, index, 1))
+                    while (is_bounded(scanner->string_length, index, 1))
                     {
                         if ((digit_count == 4) || !judo_isxdigit(string[index]))
                         {
@@ -1170,13 +1776,13 @@ static enum judo_result scan_string(const struct scanner *scanner, struct token
                         codepoint = parse_character(digits);
                         if (is_high_surrogate(codepoint))
                         {
-                            const int32_t escape_end = index;
+                            const judo_size escape_end = index;
 
                             (void)memset(digits, 0, sizeof(digits));
                             digit_count = 0;
 
                             // There needs to be a '\u' followed by four hex digits.
-                            if (is_bounded(string, scanner->string_length, index, 6))
+                            if (is_bounded(scanner->string_length, index, 6))
                             {
                                 // Low surrogates must be followed by high surrogates.
                                 if (is_match(&string[index], "\\u", 2))
@@ -1224,26 +1830,34 @@ static enum judo_result scan_string(const struct scanner *scanner, struct token
         {
             index += 1; // Consume closing quote.
             token->type = TOKEN_STRING;
-            token->lexeme_length = (int32_t)(index - scanner->index);
+            token->lexeme_length = (judo_size)(index - scanner->index);
             break;
         }
         else
         {
-            // Consume a UTF-8 code point.
-            int32_t byte_count;
-            codepoint = utf8_decode(string, scanner->string_length, index, &byte_count);
-            if (codepoint == BAD_CHARACTER_ENCODING)
-            {
-                result = bad_encoding(scanner, index, 1);
-            }
-            else if (codepoint == INPUT_TOO_LARGE)
+            // Consume a run of ASCII characters as they require no further validation.
+            // Only non-ASCII characters are decoded and validated.
+            const judo_size run_end = skip_string_text(string, scanner->string_length, index, quote_char, scanner->trusted);
+            if (run_end > index)
             {
-                struct judo_stream *s = scanner->stream; // Temporary variable for MISRA conformance.
-                result = bad_input_size(s);
+                // The run stops before the first byte that needs attention so it examines nothing past it.
+                index = run_end;
+                resume = index;
+                resume_escaped = token->escaped;
             }
             else
             {
-                index += byte_count;
+                // Consume a UTF-8 code point.
+                int32_t byte_count;
+                codepoint = utf8_decode(string, scanner->string_length, index, &byte_count);
+                if (codepoint == BAD_CHARACTER_ENCODING)
+                {
+                    result = bad_encoding(scanner, index, 1);
+                }
+                else
+                {
+                    index += byte_count;
+                }
             }
         }
     }
@@ -1251,6 +1865,10 @@ static enum judo_result scan_string(const struct scanner *scanner, struct token
     // If no errors occurred, but the end of the string was not found, then report an error.
     if ((result == JUDO_RESULT_SUCCESS) && (token->type == TOKEN_INVALID))
     { 
+        scanner->extent = scanner->string_length;
+        scanner->string_start = scanner->index;
+        scanner->string_resume = resume;
+        scanner->string_escaped = resume_escaped;
         result = bad_syntax(scanner, scanner->index, 1, "unclosed string");
     }
 
@@ -1259,9 +1877,9 @@ static enum judo_result scan_string(const struct scanner *scanner, struct token
 
 struct bytebuf
 {
-    int32_t written;
-    int32_t length;
-    int32_t capacity;
+    judo_size written;
+    judo_size length;
+    judo_size capacity;
     char *dest;
 };
 
@@ -1283,7 +1901,39 @@ static void write_bytes(struct bytebuf *b, unichar codepoint)
     b->length += bytes_needed;
 }
 
-enum judo_result judo_stringify(const char *lexeme, int32_t length, char *buf, int32_t *buflen) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+// Writes a run of characters which are copied verbatim from the lexeme. If the run doesn't
+// fit, then as many whole characters as fit are written like write_bytes() would.
+static void write_run(struct bytebuf *b, const char *bytes, judo_size count)
+{
+    if (b->length < b->capacity)
+    {
+        judo_size fits = b->capacity - b->length;
+        if (fits >= count)
+        {
+            fits = count;
+        }
+        else
+        {
+            // Don't split a multi-byte character.
+            while ((fits > 0) && (((uint8_t)bytes[fits] & (uint8_t)0xC0) == (uint8_t)0x80))
+            {
+                fits -= 1;
+            }
+        }
+
+        // LCOV_EXCL_START
+        assert(b->dest != NULL);
+        assert(b->written == b->length);
+        // LCOV_EXCL_STOP
+        // The destination may overlap the lexeme when decoding in-place.
+        (void)memmove(&b->dest[b->length], bytes, (size_t)fits);
+        b->written += fits;
+    }
+
+    b->length += count;
+}
+
+enum judo_result judo_stringify(const char *lexeme, judo_size length, char *buf, judo_size *buflen) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
 {
     enum judo_result result = JUDO_RESULT_SUCCESS;
     unichar codepoint = UNICHAR_C(0x0);
@@ -1324,8 +1974,8 @@ enum judo_result judo_stringify(const char *lexeme, int32_t length, char *buf, i
 #endif
         {
             char buffer[5];
-            int32_t index = 1;
-            int32_t stop = length - 1;
+            judo_size index = 1;
+            judo_size stop = length - 1;
             while ((result == JUDO_RESULT_SUCCESS) && (index < stop))
             {
                 if (string[index] == '\\')
@@ -1406,11 +2056,22 @@ enum judo_result judo_stringify(const char *lexeme, int32_t length, char *buf, i
                 }
                 else
                 {
-                    // Consume a UTF-8 code point.
-                    int32_t byte_count;
-                    codepoint = utf8_decode((const uint8_t *)string, length, index, &byte_count);
-                    write_bytes(&out, codepoint);
-                    index += byte_count;
+                    // Characters other than escape sequences are copied verbatim. The lexeme is
+                    // well-formed UTF-8 so they needn't be decoded and are copied a run at a time.
+                    const judo_size run_end = skip_string_text((const uint8_t *)string, stop, index, (uint8_t)string[0], true);
+                    if (run_end > index)
+                    {
+                        write_run(&out, &string[index], run_end - index);
+                        index = run_end;
+                    }
+                    else
+                    {
+                        // Consume a UTF-8 code point.
+                        int32_t byte_count;
+                        codepoint = utf8_decode((const uint8_t *)string, length, index, &byte_count);
+                        write_bytes(&out, codepoint);
+                        index += byte_count;
+                    }
                 }
             }
         }
@@ -1419,8 +2080,8 @@ enum judo_result judo_stringify(const char *lexeme, int32_t length, char *buf, i
         {
             assert(result == JUDO_RESULT_SUCCESS); // LCOV_EXCL_BR_LINE
 
-            int32_t index = 0;
-            int32_t stop = length;
+            judo_size index = 0;
+            judo_size stop = length;
             while (index < stop)
             {
                 if (string[index] == '\\')
@@ -1473,6 +2134,183 @@ enum judo_result judo_stringify(const char *lexeme, int32_t length, char *buf, i
     return result;
 }
 
+enum judo_result judo_stringify_inplace(char *lexeme, judo_size length, judo_size *buflen) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result;
+
+    if (lexeme == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (buflen == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        // The decoded string is never longer than the lexeme and every character is written
+        // at or before the position it's read from so the lexeme can be its own output buffer.
+        judo_size capacity = length;
+        result = judo_stringify(lexeme, length, lexeme, &capacity);
+        assert(result != JUDO_RESULT_NO_BUFFER_SPACE); // LCOV_EXCL_BR_LINE
+        if (result == JUDO_RESULT_SUCCESS)
+        {
+            *buflen = capacity;
+        }
+    }
+
+    return result;
+}
+
+int32_t judo_unescape(const char *lexeme, judo_size length, judo_size *index, char bytes[4])
+{
+    int32_t byte_count = 0;
+    judo_size stop = length;
+    judo_size at = *index;
+
+    // LCOV_EXCL_START
+    assert(lexeme != NULL);
+    assert(length > 0);
+    // LCOV_EXCL_STOP
+
+    // Skip the opening and closing quotes. Only JSON5 identifiers are unquoted.
+#if defined(JUDO_JSON5)
+    if ((lexeme[0] == '"') || (lexeme[0] == '\''))
+#endif
+    {
+        stop = length - 1;
+        if (at == 0)
+        {
+            at = 1;
+        }
+    }
+
+#if defined(JUDO_JSON5)
+    // A backslash followed by a line break continues the string on the next line.
+    // Both are removed from the string.
+    while ((at < stop) && (lexeme[at] == '\\') && (is_newline((const uint8_t *)lexeme, length, at + 1) >= 1))
+    {
+        at += 1 + is_newline((const uint8_t *)lexeme, length, at + 1);
+    }
+#endif
+
+    if (at < stop)
+    {
+        if (lexeme[at] == '\\')
+        {
+            unichar codepoint = UNICHAR_C(0x0);
+            char buffer[5];
+            at += 1; // skip the backslash
+
+            const char c = lexeme[at];
+            at += 1;
+            switch (c)
+            {
+            case 'b': codepoint = UNICHAR_C('\b'); break;
+            case 'f': codepoint = UNICHAR_C('\f'); break;
+            case 'n': codepoint = UNICHAR_C('\n'); break;
+            case 'r': codepoint = UNICHAR_C('\r'); break;
+            case 't': codepoint = UNICHAR_C('\t'); break;
+#if defined(JUDO_JSON5)
+            case 'v': codepoint = UNICHAR_C('\v'); break;
+            case '0': codepoint = UNICHAR_C('\0'); break;
+            case 'x':
+                buffer[0] = lexeme[at];
+                buffer[1] = lexeme[at + 1];
+                buffer[2] = '\0';
+                codepoint = parse_character(buffer);
+                at += 2;
+                break;
+#endif
+            case 'u':
+                buffer[0] = lexeme[at];
+                buffer[1] = lexeme[at + 1];
+                buffer[2] = lexeme[at + 2];
+                buffer[3] = lexeme[at + 3];
+                buffer[4] = '\0';
+                codepoint = parse_character(buffer);
+                at += 4;
+
+                if (is_high_surrogate(codepoint))
+                {
+                    // High surrogates are followed by low surrogates.
+                    buffer[0] = lexeme[at + 2];
+                    buffer[1] = lexeme[at + 3];
+                    buffer[2] = lexeme[at + 4];
+                    buffer[3] = lexeme[at + 5];
+                    buffer[4] = '\0';
+                    codepoint = (codepoint << UNICHAR_C(10)) + parse_character(buffer) + 0xFCA02400u;
+                    at += 6;
+                }
+                break;
+
+            default:
+                // Every other escape sequence represents the escaped character itself, e.g. '\"' or '\\'.
+                codepoint = (unichar)(uint8_t)c;
+                break;
+            }
+            byte_count = utf8_encode(codepoint, bytes);
+        }
+        else
+        {
+            // The input is well-formed UTF-8 so characters are passed through a byte at a time.
+            bytes[0] = lexeme[at];
+            byte_count = 1;
+            at += 1;
+        }
+    }
+
+    *index = at;
+    return byte_count;
+}
+
+bool judo_verbatim(const char *lexeme, judo_size length, struct judo_span *content)
+{
+    content->offset = 0;
+    content->length = length;
+#if defined(JUDO_JSON5)
+    if ((lexeme[0] == '"') || (lexeme[0] == '\''))
+#endif
+    {
+        content->offset = 1;
+        content->length = length - 2;
+    }
+    return memchr(&lexeme[content->offset], '\\', (size_t)content->length) == NULL;
+}
+
+bool judo_nameeq(const char *lexeme, judo_size length, const char *key, judo_size keylen)
+{
+    struct judo_span content;
+    bool equal;
+
+    if (judo_verbatim(lexeme, length, &content))
+    {
+        equal = (content.length == keylen) && (memcmp(&lexeme[content.offset], key, (size_t)keylen) == 0);
+    }
+    else
+    {
+        char bytes[4];
+        judo_size index = 0;
+        judo_size matched = 0;
+        int32_t count = judo_unescape(lexeme, length, &index, bytes);
+        equal = true;
+        while (equal && (count > 0))
+        {
+            if ((count > (keylen - matched)) || (memcmp(&key[matched], bytes, (size_t)count) != 0))
+            {
+                equal = false;
+            }
+            else
+            {
+                matched += count;
+                count = judo_unescape(lexeme, length, &index, bytes);
+            }
+        }
+        equal = equal && (matched == keylen);
+    }
+    return equal;
+}
+
 static bool is_starter(unichar c)
 {
     bool s;
@@ -1518,7 +2356,7 @@ static bool is_continue(unichar c)
 static void scan_keyword(const struct scanner *scanner, struct token *token)
 {
     const uint8_t *string = &scanner->string[scanner->index];
-    int32_t index = scanner->index;
+    judo_size index = scanner->index;
 
     int32_t byte_count = 0;
     unichar codepoint = utf8_decode(scanner->string, scanner->string_length, index, &byte_count);
@@ -1536,7 +2374,7 @@ static void scan_keyword(const struct scanner *scanner, struct token *token)
             index += byte_count;
         }
 
-        int32_t token_length = index - scanner->index;
+        judo_size token_length = index - scanner->index;
         if (is_match(string, "null", token_length))
         {
             token->type = TOKEN_NULL;
@@ -1554,9 +2392,10 @@ static void scan_keyword(const struct scanner *scanner, struct token *token)
         }
 #if defined(JUDO_JSON5)
         else if (is_match(string, "NaN", token_length) ||
-                 is_match(string, "Infinite", token_length))
+                 is_match(string, "Infinity", token_length))
         {
             token->type = TOKEN_NUMBER;
+            token->numtype = JUDO_NUMTYPE_SPECIAL;
             token->lexeme_length = token_length;
         }
 #endif
@@ -1569,14 +2408,14 @@ static void scan_keyword(const struct scanner *scanner, struct token *token)
 }
 
 #if defined(JUDO_JSON5)
-static enum judo_result scan_unicode_escape(const struct scanner *scanner, int32_t cursor)
+static enum judo_result scan_unicode_escape(const struct scanner *scanner, judo_size cursor)
 {
     enum judo_result result = JUDO_RESULT_SUCCESS;
-    int32_t index = cursor;
+    judo_size index = cursor;
     index += 1; // skip the backslash
 
     // There needs to be at least 5 more characters have the slash: the 'u' character and four hex digits.
-    if (!is_bounded(scanner->string, scanner->string_length, index, 5))
+    if (!is_bounded(scanner->string_length, index, 5))
     {
         result = bad_syntax(scanner, cursor, 1, "expected Unicode escape sequence");
     }
@@ -1597,7 +2436,7 @@ static enum judo_result scan_unicode_escape(const struct scanner *scanner, int32
 
         if (digit_count < 4)
         {
-            result = bad_syntax(scanner, cursor, index, "expected four hex digits");
+            result = bad_syntax(scanner, cursor, index - cursor, "expected four hex digits");
         }
     }
 
@@ -1608,7 +2447,7 @@ static enum judo_result scan_ES5_identifier(const struct scanner *scanner, struc
 {
     enum judo_result result = JUDO_RESULT_SUCCESS;
     const uint8_t *string = &scanner->string[scanner->index];
-    int32_t index = scanner->index;
+    judo_size index = scanner->index;
 
     int32_t byte_count = 0;
     unichar codepoint = utf8_decode(scanner->string, scanner->string_length, index, &byte_count);
@@ -1618,6 +2457,7 @@ static enum judo_result scan_ES5_identifier(const struct scanner *scanner, struc
         if (codepoint == UNICHAR_C('\\'))
         {
             result = scan_unicode_escape(scanner, index);
+            token->escaped = true;
             byte_count = 6;
         }
         index += byte_count;
@@ -1628,6 +2468,7 @@ static enum judo_result scan_ES5_identifier(const struct scanner *scanner, struc
             if (codepoint == UNICHAR_C('\\'))
             {
                 result = scan_unicode_escape(scanner, index);
+                token->escaped = true;
                 byte_count = 6;
             }
             else
@@ -1643,7 +2484,7 @@ static enum judo_result scan_ES5_identifier(const struct scanner *scanner, struc
         if (result == JUDO_RESULT_SUCCESS)
         {
             // JSON5 requires that object keys may be an ECMAScript 5.1 IdentifierName.
-            int32_t token_length = index - scanner->index;
+            judo_size token_length = index - scanner->index;
             switch ((char)string[0])
             {
             case 'b':
@@ -1800,9 +2641,9 @@ static enum judo_result scan_ES5_identifier(const struct scanner *scanner, struc
 #endif
 
 #if defined(JUDO_JSON5) || defined(JUDO_WITH_COMMENTS)
-static enum judo_result scan_comment(const struct scanner *scanner, int32_t *byte_count)
+static enum judo_result scan_comment(const struct scanner *scanner, judo_size *byte_count)
 {
-    int32_t index = scanner->index + 2; // +2 to skip the '/' and '/'
+    judo_size index = scanner->index + 2; // +2 to skip the '/' and '/'
 
     while (is_newline(scanner->string, scanner->string_length, index) == 0)
     {
@@ -1821,10 +2662,10 @@ static enum judo_result scan_comment(const struct scanner *scanner, int32_t *byt
     return JUDO_RESULT_SUCCESS;
 }
 
-static enum judo_result scan_multiline_comment(const struct scanner *scanner, int32_t *byte_count)
+static enum judo_result scan_multiline_comment(struct scanner *scanner, judo_size *byte_count)
 {
     enum judo_result result;
-    int32_t index = scanner->index + 2; // +2 to skip the '/' and '*'
+    judo_size index = scanner->index + 2; // +2 to skip the '/' and '*'
     int32_t seqlen = 0;
     unichar codepoint = 0x0;
 
@@ -1832,7 +2673,7 @@ static enum judo_result scan_multiline_comment(const struct scanner *scanner, in
 
     do
     {
-        if (is_bounded(scanner->string, scanner->string_length, index, 2))
+        if (is_bounded(scanner->string_length, index, 2))
         {
             if (is_match(&scanner->string[index], "*/", 2))
             {
@@ -1851,13 +2692,9 @@ static enum judo_result scan_multiline_comment(const struct scanner *scanner, in
     {
         result = bad_encoding(scanner, index, 1);
     }
-    else if (codepoint == INPUT_TOO_LARGE)
-    {
-        struct judo_stream *s = scanner->stream; // Temporary variable for MISRA conformance.
-        result = bad_input_size(s);
-    }
     else if (*byte_count == 0)
     {
+        scanner->extent = scanner->string_length;
         result = bad_syntax(scanner, scanner->index, 2, "unterminated multi-line comment");
     }
     else
@@ -1903,6 +2740,69 @@ static bool is_space(unichar codepoint)
     return b;
 }
 
+static inline bool is_ascii_space(uint8_t byte)
+{
+    bool b;
+
+    switch (byte)
+    {
+        case 0x20: // Space
+        case 0x09: // Horizontal tab
+        case 0x0A: // Line feed
+        case 0x0D: // Carriage return
+#if defined(JUDO_JSON5)
+        case 0x0B: // Vertical tab
+        case 0x0C: // Form feed
+#endif
+            b = true;
+            break;
+
+        default:
+            b = false;
+            break;
+    }
+
+    return b;
+}
+
+// Skips a run of ASCII whitespace without decoding it. Indentation makes up a significant
+// portion of pretty-printed JSON so, when possible, whitespace is skipped a block at a time.
+// The returned index is always aligned to a code point boundary. Any non-ASCII whitespace
+// (permitted by JSON5) is left for the caller to decode.
+static judo_size skip_ascii_space(const uint8_t *string, judo_size length, judo_size cursor)
+{
+    judo_size index = cursor;
+    judo_size stop = length;
+
+#if defined(JUDO_SIMD_WIDTH)
+    while ((stop - index) >= JUDO_SIMD_WIDTH)
+    {
+        const simd_block block = simd_load(&string[index]);
+        uint32_t space = simd_eq(block, (uint8_t)0x20) |
+                         simd_eq(block, (uint8_t)0x09) |
+                         simd_eq(block, (uint8_t)0x0A) |
+                         simd_eq(block, (uint8_t)0x0D);
+#if defined(JUDO_JSON5)
+        space |= simd_eq(block, (uint8_t)0x0B) | simd_eq(block, (uint8_t)0x0C);
+#endif
+        if (space != SIMD_MASK_ALL)
+        {
+            index += judo_ctz(~space);
+            stop = index; // Found the first non-whitespace byte.
+            break;
+        }
+        index += JUDO_SIMD_WIDTH;
+    }
+#endif
+
+    while ((index < stop) && is_ascii_space(string[index]))
+    {
+        index += 1;
+    }
+
+    return index;
+}
+
 static enum judo_result consume_space_and_comments(struct scanner *scanner)
 {
     enum judo_result result = JUDO_RESULT_SUCCESS;
@@ -1910,14 +2810,19 @@ static enum judo_result consume_space_and_comments(struct scanner *scanner)
     // Consume all the whitespace characters leading up to the token.
     for (;;)
     {
-        int32_t byte_count = 0;
-        const unichar codepoint = utf8_decode(scanner->string, scanner->string_length, scanner->index, &byte_count);
-        if (!is_space(codepoint))
-        {
-            byte_count = 0;
+        judo_size byte_count = 0;
+        scanner->index = skip_ascii_space(scanner->string, scanner->string_length, scanner->index);
 
+        int32_t seqlen = 0;
+        const unichar codepoint = utf8_decode(scanner->string, scanner->string_length, scanner->index, &seqlen);
+        if (is_space(codepoint))
+        {
+            byte_count = seqlen;
+        }
+        else
+        {
 #if defined(JUDO_WITH_COMMENTS) || defined(JUDO_JSON5)
-            if (is_bounded(scanner->string, scanner->string_length, scanner->index, 2))
+            if (is_bounded(scanner->string_length, scanner->index, 2))
             {
                 if (is_match(&scanner->string[scanner->index], "//", 2))
                 {
@@ -1971,10 +2876,6 @@ static enum judo_result peek(struct scanner *scanner, struct token *token)
             result = bad_encoding(scanner, scanner->index, 1);
             break;
 
-        case INPUT_TOO_LARGE:
-            result = bad_input_size(scanner->stream);
-            break;
-
         case UNICHAR_C('\0'):
             if (byte_count > 0)
             {
@@ -2053,6 +2954,14 @@ static enum judo_result peek(struct scanner *scanner, struct token *token)
         }
     }
 
+    // Errors are reported where they're detected which can precede the end of the
+    // lexeme, such as a grammar error for a token that ran to the end of the input.
+    const judo_size lexed = (result == JUDO_RESULT_SUCCESS) ? (token->lexeme + token->lexeme_length) : (scanner->stream->where.offset + scanner->stream->where.length);
+    if (lexed > scanner->extent)
+    {
+        scanner->extent = lexed;
+    }
+
     return result;
 }
 
@@ -2085,7 +2994,7 @@ static enum judo_result parse_null(struct scanner *scanner, const struct token *
     eat(scanner, token);
     scanner->stream->where = (struct judo_span){token->lexeme, token->lexeme_length};
     scanner->stream->token = JUDO_TOKEN_NULL;
-    scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_FINISHED_PARSING_VALUE;
+    set_state(scanner->stream, SCAN_STATE_FINISHED_PARSING_VALUE);
     return JUDO_RESULT_SUCCESS;
 }
 
@@ -2100,7 +3009,7 @@ static enum judo_result parse_bool(struct scanner *scanner, const struct token *
     eat(scanner, token);
     scanner->stream->where = (struct judo_span){token->lexeme, token->lexeme_length};
     scanner->stream->token = (token->type == TOKEN_TRUE) ? JUDO_TOKEN_TRUE : JUDO_TOKEN_FALSE;
-    scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_FINISHED_PARSING_VALUE;
+    set_state(scanner->stream, SCAN_STATE_FINISHED_PARSING_VALUE);
     return JUDO_RESULT_SUCCESS;
 }
 
@@ -2110,7 +3019,9 @@ static enum judo_result parse_number(struct scanner *scanner, const struct token
     eat(scanner, token);
     scanner->stream->where = (struct judo_span){token->lexeme, token->lexeme_length};
     scanner->stream->token = JUDO_TOKEN_NUMBER;
-    scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_FINISHED_PARSING_VALUE;
+    scanner->stream->numtype = token->numtype;
+    scanner->stream->digits = token->digits;
+    set_state(scanner->stream, SCAN_STATE_FINISHED_PARSING_VALUE);
     return JUDO_RESULT_SUCCESS;
 }
 
@@ -2120,7 +3031,8 @@ static enum judo_result parse_string(struct scanner *scanner, const struct token
     eat(scanner, token);
     scanner->stream->where = (struct judo_span){token->lexeme, token->lexeme_length};
     scanner->stream->token = JUDO_TOKEN_STRING;
-    scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_FINISHED_PARSING_VALUE;
+    scanner->stream->escaped = token->escaped;
+    set_state(scanner->stream, SCAN_STATE_FINISHED_PARSING_VALUE);
     return JUDO_RESULT_SUCCESS;
 }
 
@@ -2132,14 +3044,15 @@ static enum judo_result parse_array(struct scanner *scanner, const struct token
     eat(scanner, token);
     scanner->stream->where = (struct judo_span){token->lexeme, token->lexeme_length};
     scanner->stream->token = JUDO_TOKEN_ARRAY_BEGIN;
-    scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_PARSE_ARRAY_END_OR_ARRAY_ELEMENT;
+    set_kind(scanner->stream, false);
+    set_state(scanner->stream, SCAN_STATE_PARSE_ARRAY_END_OR_ARRAY_ELEMENT);
     return JUDO_RESULT_SUCCESS;
 }
 
 static enum judo_result parse_array_element(struct scanner *scanner)
 {
     // After the array token has been parsed, we should check for a comma.
-    scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_FINISHED_PARSING_ARRAY_ELEMENT;
+    set_state(scanner->stream, SCAN_STATE_FINISHED_PARSING_ARRAY_ELEMENT);
     return parse_value(scanner, "expected value");
 }
 
@@ -2154,7 +3067,7 @@ static enum judo_result parse_array_element_or_array_end(struct scanner *scanner
             eat(scanner, &token);
             scanner->stream->where = (struct judo_span){token.lexeme, token.lexeme_length};
             scanner->stream->token = JUDO_TOKEN_ARRAY_END;
-            scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_FINISHED_PARSING_VALUE;
+            set_state(scanner->stream, SCAN_STATE_FINISHED_PARSING_VALUE);
         }
         else
         {
@@ -2186,7 +3099,7 @@ static enum judo_result finished_parsing_array_element(struct scanner *scanner)
                 eat(scanner, &token);
                 scanner->stream->where = (struct judo_span){token.lexeme, token.lexeme_length};
                 scanner->stream->token = JUDO_TOKEN_ARRAY_END;
-                scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_FINISHED_PARSING_VALUE;
+                set_state(scanner->stream, SCAN_STATE_FINISHED_PARSING_VALUE);
                 result = JUDO_RESULT_SUCCESS;
             }
             else
@@ -2204,7 +3117,8 @@ static enum judo_result parse_object(struct scanner *scanner, const struct token
     eat(scanner, token);
     scanner->stream->where = (struct judo_span){token->lexeme, token->lexeme_length};
     scanner->stream->token = JUDO_TOKEN_OBJECT_BEGIN;
-    scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_PARSE_OBJECT_KEY_OR_OBJECT_END;
+    set_kind(scanner->stream, true);
+    set_state(scanner->stream, SCAN_STATE_PARSE_OBJECT_KEY_OR_OBJECT_END);
     return JUDO_RESULT_SUCCESS;
 }
 
@@ -2216,7 +3130,8 @@ static enum judo_result parse_object_key(struct scanner *scanner, const struct t
         eat(scanner, token);
         scanner->stream->where = (struct judo_span){token->lexeme, token->lexeme_length};
         scanner->stream->token = JUDO_TOKEN_OBJECT_NAME;
-        scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_PARSE_OBJECT_VALUE;
+        scanner->stream->escaped = token->escaped;
+        set_state(scanner->stream, SCAN_STATE_PARSE_OBJECT_VALUE);
     }
 #if defined(JUDO_JSON5)
     else if (token->type == TOKEN_IDENTIFIER)
@@ -2224,7 +3139,8 @@ static enum judo_result parse_object_key(struct scanner *scanner, const struct t
         eat(scanner, token);
         scanner->stream->where = (struct judo_span){token->lexeme, token->lexeme_length};
         scanner->stream->token = JUDO_TOKEN_OBJECT_NAME;
-        scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_PARSE_OBJECT_VALUE;
+        scanner->stream->escaped = token->escaped;
+        set_state(scanner->stream, SCAN_STATE_PARSE_OBJECT_VALUE);
     }
 #endif
     else
@@ -2242,7 +3158,7 @@ static enum judo_result parse_object_value(struct scanner *scanner)
     {
         if (accepted)
         {
-            scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_FINISHED_PARSING_OBJECT_VALUE;
+            set_state(scanner->stream, SCAN_STATE_FINISHED_PARSING_OBJECT_VALUE);
             result = parse_value(scanner, "expected value after ':'");
         }
         else
@@ -2264,7 +3180,7 @@ static enum judo_result parse_object_key_or_object_end(struct scanner *scanner)
             eat(scanner, &token);
             scanner->stream->where = (struct judo_span){token.lexeme, token.lexeme_length};
             scanner->stream->token = JUDO_TOKEN_OBJECT_END;
-            scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_FINISHED_PARSING_VALUE;
+            set_state(scanner->stream, SCAN_STATE_FINISHED_PARSING_VALUE);
             result = JUDO_RESULT_SUCCESS;
         }
         else
@@ -2302,7 +3218,7 @@ static enum judo_result finished_parsing_object_value(struct scanner *scanner)
                 eat(scanner, &token);
                 scanner->stream->where = (struct judo_span){token.lexeme, token.lexeme_length};
                 scanner->stream->token = JUDO_TOKEN_OBJECT_END;
-                scanner->stream->s_state[scanner->stream->s_stack] = SCAN_STATE_FINISHED_PARSING_VALUE;
+                set_state(scanner->stream, SCAN_STATE_FINISHED_PARSING_VALUE);
                 result = JUDO_RESULT_SUCCESS;
             }
             else
@@ -2319,7 +3235,7 @@ static enum judo_result parse_value(struct scanner *scanner, const char *msg)
     enum judo_result result;
 
     // Check to ensure that the maximum level of nesting hasn't been reached.
-    if (scanner->stream->s_stack >= (JUDO_MAXDEPTH - 1))
+    if (scanner->stream->s_stack >= (max_depth(scanner->stream) - 1))
     {
         result = max_nesting_depth(scanner);;
     }
@@ -2375,7 +3291,7 @@ static enum judo_result parse_value(struct scanner *scanner, const char *msg)
 static enum judo_result parse_root(struct scanner *scanner)
 {
     // Skip UTF-8 BOM (if present).
-    if (is_bounded(scanner->string, scanner->string_length, scanner->index, 3))
+    if (is_bounded(scanner->string_length, scanner->index, 3))
     {
         const uint8_t utf8_bom[] = {(uint8_t)0xEF, (uint8_t)0xBB, (uint8_t)0xBF};
         if (memcmp(scanner->string, utf8_bom, 3) == 0)
@@ -2427,113 +3343,719 @@ static enum judo_result parse_root(struct scanner *scanner)
     return result;
 }
 
-enum judo_result judo_scan(struct judo_stream *stream, const char *source, int32_t length) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+// Advances the scanner to the next semantic token and records it in the stream.
+static enum judo_result scan_token(struct scanner *scanner)
 {
+    struct judo_stream *stream = scanner->stream;
     enum judo_result result = JUDO_RESULT_SUCCESS;
 
-    if (stream == NULL)
-    {
-        result = JUDO_RESULT_INVALID_OPERATION;
-    }
-
-    if (source == NULL)
-    {
-        result = JUDO_RESULT_INVALID_OPERATION;
-    }
-
-    if (length >= JUDO_MAXIMUM_INPUT_SIZE)
-    {
-        result = bad_input_size(stream);
-    }
+    // Only strings and object names have escape sequences and only numbers are classified.
+    stream->escaped = false;
+    stream->numtype = JUDO_NUMTYPE_INVALID;
+    stream->digits = 0;
 
-    if (result == JUDO_RESULT_SUCCESS)
+    // If we finished parsing a value at the index stack depth, then pop the stack.
+    // We do this before the switch statement to ensure it always operators on an unfinished value.
+    if (get_state(stream) == SCAN_STATE_FINISHED_PARSING_VALUE)
     {
-        struct scanner scanner;
-        scanner.stream = stream;
-        scanner.string = (const uint8_t *)source;
-        scanner.string_length = length;
-        scanner.index = stream->s_at;
-        result = JUDO_RESULT_SUCCESS;
-
-        // If we finished parsing a value at the index stack depth, then pop the stack.
-        // We do this before the switch statement to ensure it always operators on an unfinished value.
-        if (stream->s_state[stream->s_stack] == SCAN_STATE_FINISHED_PARSING_VALUE)
+        if (stream->s_stack == 0)
         {
-            if (stream->s_stack == 0)
+            struct token token = {0};
+            result = peek(scanner, &token);
+            if (result == JUDO_RESULT_SUCCESS)
             {
-                struct token token = {0};
-                result = peek(&scanner, &token);
-                if (result == JUDO_RESULT_SUCCESS)
+                if (token.type == TOKEN_EOF)
                 {
-                    if (token.type == TOKEN_EOF)
-                    {
-                        stream->token = JUDO_TOKEN_EOF;
-                        stream->where = (struct judo_span){token.lexeme, token.lexeme_length};
-                        stream->s_state[stream->s_stack] = SCAN_STATE_FINISHED_PARSING;
-                    }
-                    else
-                    {
-                        const int32_t at = scanner.index;
-                        result = bad_syntax(&scanner, at, 1, "expected EOF");
-                    }
+                    stream->token = JUDO_TOKEN_EOF;
+                    stream->where = (struct judo_span){token.lexeme, token.lexeme_length};
+                    set_state(stream, SCAN_STATE_FINISHED_PARSING);
+                }
+                else
+                {
+                    const judo_size at = scanner->index;
+                    result = bad_syntax(scanner, at, 1, "expected EOF");
                 }
-            }
-            else
-            {
-                stream->s_stack -= 1;
             }
         }
+        else
+        {
+            pop_state(stream);
+        }
+    }
 
-        if (result == JUDO_RESULT_SUCCESS)
+    if (result == JUDO_RESULT_SUCCESS)
+    {
+        switch (get_state(stream))
         {
-            switch (stream->s_state[stream->s_stack])
-            {
-            case SCAN_STATE_ROOT_VALUE:
-                result = parse_root(&scanner);
-                break;
+        case SCAN_STATE_ROOT_VALUE:
+            result = parse_root(scanner);
+            break;
 
-            case SCAN_STATE_FINISHED_PARSING_ARRAY_ELEMENT:
-                result = finished_parsing_array_element(&scanner);
-                break;
+        case SCAN_STATE_FINISHED_PARSING_ARRAY_ELEMENT:
+            result = finished_parsing_array_element(scanner);
+            break;
 
-            case SCAN_STATE_PARSE_ARRAY_END_OR_ARRAY_ELEMENT:
-                result = parse_array_element_or_array_end(&scanner);
-                break;
+        case SCAN_STATE_PARSE_ARRAY_END_OR_ARRAY_ELEMENT:
+            result = parse_array_element_or_array_end(scanner);
+            break;
 
-            case SCAN_STATE_PARSE_OBJECT_KEY_OR_OBJECT_END:
-                result = parse_object_key_or_object_end(&scanner);
-                break;
+        case SCAN_STATE_PARSE_OBJECT_KEY_OR_OBJECT_END:
+            result = parse_object_key_or_object_end(scanner);
+            break;
 
-            case SCAN_STATE_PARSE_OBJECT_VALUE:
-                result = parse_object_value(&scanner);
-                break;
+        case SCAN_STATE_PARSE_OBJECT_VALUE:
+            result = parse_object_value(scanner);
+            break;
 
-            case SCAN_STATE_FINISHED_PARSING_OBJECT_VALUE:
-                result = finished_parsing_object_value(&scanner);
-                break;
+        case SCAN_STATE_FINISHED_PARSING_OBJECT_VALUE:
+            result = finished_parsing_object_value(scanner);
+            break;
+
+        case SCAN_STATE_PARSING_ERROR:
+            result = JUDO_RESULT_BAD_SYNTAX;
+            break;
+
+        case SCAN_STATE_ENCODING_ERROR:
+            result = JUDO_RESULT_ILLEGAL_BYTE_SEQUENCE;
+            break;
+
+        case SCAN_STATE_MAX_NESTING_ERROR:
+            result = JUDO_RESULT_MAXIMUM_NESTING;
+            break;
+
+        case SCAN_STATE_FINISHED_PARSING:
+            break;
+
+        default:
+            result = JUDO_RESULT_MALFUNCTION;
+            break;
+        }
+
+        stream->s_at = scanner->index;
+    }
+
+    return result;
+}
+
+// Determines the length of the input. The scanner implementation only operates on input of
+// known length so that it needn't probe for the null terminator with every byte it reads.
+// The length of null terminated input is computed once and remembered by the stream.
+static bool measure_input(const struct judo_stream *stream, const char *source, judo_size length, judo_size *measured)
+{
+    bool bounded = true;
+
+    if (length >= 0)
+    {
+        *measured = length;
+    }
+    else if ((stream->s_flags & STREAM_MEASURED) != 0u)
+    {
+        *measured = stream->s_length;
+    }
+    else
+    {
+        const size_t n = strlen(source);
+        *measured = ((uint64_t)n < (uint64_t)JUDO_MAXIMUM_INPUT_SIZE) ? (judo_size)n : JUDO_MAXIMUM_INPUT_SIZE;
+    }
+
+    if (*measured >= JUDO_MAXIMUM_INPUT_SIZE)
+    {
+        bounded = false;
+    }
+
+    return bounded;
+}
+
+// Validates the arguments common to the scanning functions and prepares a scanner to resume
+// scanning from where the stream left off.
+static enum judo_result init_scanner(struct scanner *scanner, struct judo_stream *stream, const char *source, judo_size length)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    judo_size source_length = 0;
 
-            case SCAN_STATE_PARSING_ERROR:
-                result = JUDO_RESULT_BAD_SYNTAX;
+    if (stream == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (source == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (!measure_input(stream, source, length, &source_length))
+    {
+        result = bad_input_size(stream);
+    }
+    else if (length < 0)
+    {
+        stream->s_length = source_length;
+        stream->s_flags |= STREAM_MEASURED;
+    }
+    else
+    {
+        // The input length is valid.
+    }
+
+    if (result == JUDO_RESULT_SUCCESS)
+    {
+        scanner->stream = stream;
+        scanner->string = (const uint8_t *)source;
+        scanner->string_length = source_length;
+        scanner->index = stream->s_at;
+        scanner->trusted = (stream->s_flags & STREAM_PREVALIDATED) != 0u;
+        scanner->extent = stream->s_at;
+        scanner->string_start = -1;
+        scanner->string_resume = 0;
+        scanner->string_escaped = false;
+    }
+
+    return result;
+}
+
+enum judo_result judo_scan(struct judo_stream *stream, const char *source, judo_size length) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    struct scanner scanner;
+    enum judo_result result = init_scanner(&scanner, stream, source, length);
+    if (result == JUDO_RESULT_SUCCESS)
+    {
+        result = scan_token(&scanner);
+    }
+    return result;
+}
+
+enum judo_result judo_scan_many(struct judo_stream *stream, const char *source, judo_size length, struct judo_item *items, int32_t capacity, int32_t *count) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result;
+
+    if (count == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (items == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+        *count = 0;
+    }
+    else if (capacity <= 0)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+        *count = 0;
+    }
+    else
+    {
+        struct scanner scanner;
+        int32_t n = 0;
+
+        // The scanner is prepared once and reused for every token in the batch.
+        result = init_scanner(&scanner, stream, source, length);
+        while ((result == JUDO_RESULT_SUCCESS) && (n < capacity))
+        {
+            result = scan_token(&scanner);
+            if (result == JUDO_RESULT_SUCCESS)
+            {
+                items[n].token = stream->token;
+                items[n].where = stream->where;
+                items[n].escaped = stream->escaped;
+                items[n].numtype = stream->numtype;
+                items[n].digits = stream->digits;
+                n += 1;
+
+                // The end of the input is always the last token in the batch.
+                if (stream->token == JUDO_TOKEN_EOF)
+                {
+                    break;
+                }
+            }
+        }
+
+        *count = n;
+    }
+
+    return result;
+}
+
+// Checks if the byte is of interest when skipping a container: a bracket or a byte which may
+// begin a string or comment, since they may contain brackets.
+static inline bool is_skip_byte(uint8_t byte)
+{
+    bool is;
+    switch (byte)
+    {
+    case (uint8_t)'[':
+    case (uint8_t)']':
+    case (uint8_t)'{':
+    case (uint8_t)'}':
+    case (uint8_t)'"':
+#if defined(JUDO_JSON5)
+    case (uint8_t)'\'':
+#endif
+#if defined(JUDO_WITH_COMMENTS) || defined(JUDO_JSON5)
+    case (uint8_t)'/':
+#endif
+        is = true;
+        break;
+
+    default:
+        is = false;
+        break;
+    }
+    return is;
+}
+
+// Advances to the next byte of interest when skipping a container. The brackets preceding the
+// first quote or slash of a block are counted a block at a time, provided they can neither close
+// the container nor reach the nesting 'limit', so only the brackets which might do either and
+// the strings and comments are left for the caller to examine individually. The 'deepest' depth
+// is raised to at least the depth reached within the counted blocks.
+static judo_size count_brackets(const uint8_t *string, judo_size length, judo_size cursor, judo_size *depth, judo_size limit, judo_size *deepest)
+{
+    judo_size index = cursor;
+    judo_size stop = length;
+
+#if defined(JUDO_SIMD_WIDTH)
+    while ((stop - index) >= JUDO_SIMD_WIDTH)
+    {
+        const simd_block block = simd_load(&string[index]);
+        const uint32_t opens = simd_eq(block, (uint8_t)'[') | simd_eq(block, (uint8_t)'{');
+        const uint32_t closes = simd_eq(block, (uint8_t)']') | simd_eq(block, (uint8_t)'}');
+        uint32_t others = simd_eq(block, (uint8_t)'"');
+#if defined(JUDO_JSON5)
+        others |= simd_eq(block, (uint8_t)'\'');
+#endif
+#if defined(JUDO_WITH_COMMENTS) || defined(JUDO_JSON5)
+        others |= simd_eq(block, (uint8_t)'/');
+#endif
+        const uint32_t before = (others == 0u) ? SIMD_MASK_ALL : ((others & (0u - others)) - 1u);
+        const judo_size opened = judo_popcount(opens & before);
+        const judo_size closed = judo_popcount(closes & before);
+        if ((closed < *depth) && ((*depth + opened) < limit))
+        {
+            if ((*depth + opened) > *deepest)
+            {
+                *deepest = *depth + opened;
+            }
+            *depth += opened - closed;
+            if (others != 0u)
+            {
+                index += judo_ctz(others);
+                stop = index; // Found a string or comment.
                 break;
+            }
+            index += JUDO_SIMD_WIDTH;
+        }
+        else
+        {
+            // The depth is only at the limit when the index is at a closing bracket so the block
+            // always has a bracket before the first quote or slash.
+            index += judo_ctz((opens | closes) & before);
+            stop = index;
+            break;
+        }
+    }
+#else
+    (void)depth;
+    (void)limit;
+    (void)deepest;
+#endif
+
+    while ((index < stop) && !is_skip_byte(string[index]))
+    {
+        index += 1;
+    }
+
+    return index;
+}
+
+// Skips a string without decoding or validating it. Returns the index after its closing quote.
+static enum judo_result skip_quoted(const struct scanner *scanner, judo_size cursor, judo_size *end)
+{
+    const uint8_t quote_char = scanner->string[cursor];
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    judo_size index = cursor + 1;
+    bool closed = false;
+
+    while (!closed && (result == JUDO_RESULT_SUCCESS))
+    {
+        index = skip_string_text(scanner->string, scanner->string_length, index, quote_char, true);
+        if (index >= scanner->string_length)
+        {
+            result = bad_syntax(scanner, cursor, 1, "unclosed string");
+        }
+        else if (scanner->string[index] == quote_char)
+        {
+            closed = true;
+            index += 1;
+        }
+        else if ((scanner->string[index] == (uint8_t)0x5C) && is_bounded(scanner->string_length, index, 2))
+        {
+            index += 2; // The escaped character cannot end the string.
+        }
+        else
+        {
+            index += 1;
+        }
+    }
+
+    *end = index;
+    return result;
+}
+
+// The innermost container permitted by the nesting depth cannot have elements or members so
+// the next token, after the opening bracket at 'index', must be a closing bracket.
+static enum judo_result expect_empty(struct scanner *scanner, judo_size *index)
+{
+    scanner->index = *index;
+    enum judo_result result = consume_space_and_comments(scanner);
+    *index = scanner->index;
+    if (result == JUDO_RESULT_SUCCESS)
+    {
+        if (!is_bounded(scanner->string_length, *index, 1) || ((scanner->string[*index] != (uint8_t)']') && (scanner->string[*index] != (uint8_t)'}')))
+        {
+            result = max_nesting_depth(scanner);
+        }
+    }
+    return result;
+}
 
-            case SCAN_STATE_ENCODING_ERROR:
-                result = JUDO_RESULT_ILLEGAL_BYTE_SEQUENCE;
+// Skips the array or object whose opening bracket was just scanned by counting its brackets.
+// Strings and comments are recognized but nothing is validated except that the brackets are
+// balanced, the closing bracket matches the opening bracket, and the nesting does not reach
+// 'limit' levels. The number of levels the value nests is written to 'deepest'.
+static enum judo_result skip_relaxed(struct scanner *scanner, judo_size limit, judo_size *deepest)
+{
+    struct judo_stream *stream = scanner->stream;
+    const bool is_array = (stream->token == JUDO_TOKEN_ARRAY_BEGIN);
+    const char *expected = is_array ? "expected ']' or ','" : "expected '}' or ','";
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    judo_size depth = 1;
+    judo_size index = scanner->index;
+
+    *deepest = depth;
+    if (depth == limit)
+    {
+        result = expect_empty(scanner, &index);
+    }
+
+    while ((result == JUDO_RESULT_SUCCESS) && (depth > 0))
+    {
+        index = count_brackets(scanner->string, scanner->string_length, index, &depth, limit, deepest);
+        if (index >= scanner->string_length)
+        {
+            result = bad_syntax(scanner, scanner->string_length, 1, expected);
+        }
+        else
+        {
+            switch ((char)scanner->string[index])
+            {
+            case '[':
+            case '{':
+                depth += 1;
+                index += 1;
+                if (depth > *deepest)
+                {
+                    *deepest = depth;
+                }
+                if (depth == limit)
+                {
+                    result = expect_empty(scanner, &index);
+                }
                 break;
 
-            case SCAN_STATE_MAX_NESTING_ERROR:
-                result = JUDO_RESULT_MAXIMUM_NESTING;
+            case ']':
+            case '}':
+                depth -= 1;
+                if ((depth == 0) && ((scanner->string[index] == (uint8_t)']') != is_array))
+                {
+                    result = bad_syntax(scanner, index, 1, expected);
+                }
+                index += 1;
                 break;
 
-            case SCAN_STATE_FINISHED_PARSING:
+#if defined(JUDO_WITH_COMMENTS) || defined(JUDO_JSON5)
+            case '/':
+            {
+                judo_size byte_count = 1;
+                scanner->index = index;
+                if (is_bounded(scanner->string_length, index, 2) && is_match(&scanner->string[index], "//", 2))
+                {
+                    result = scan_comment(scanner, &byte_count);
+                }
+                else if (is_bounded(scanner->string_length, index, 2) && is_match(&scanner->string[index], "/*", 2))
+                {
+                    result = scan_multiline_comment(scanner, &byte_count);
+                }
+                else
+                {
+                    // A stray slash isn't validated.
+                }
+                index += byte_count;
                 break;
+            }
+#endif
 
             default:
-                result = JUDO_RESULT_MALFUNCTION;
+                // The byte is a quote which begins a string.
+                result = skip_quoted(scanner, index, &index);
                 break;
             }
+        }
+    }
 
+    if (result == JUDO_RESULT_SUCCESS)
+    {
+        stream->where = (struct judo_span){index - 1, 1};
+        stream->token = is_array ? JUDO_TOKEN_ARRAY_END : JUDO_TOKEN_OBJECT_END;
+        set_state(stream, SCAN_STATE_FINISHED_PARSING_VALUE);
+        scanner->index = index;
+    }
+
+    return result;
+}
+
+// Skips the array or object whose opening bracket was just scanned by scanning its tokens.
+static enum judo_result skip_tokens(struct scanner *scanner)
+{
+    const struct judo_stream *stream = scanner->stream;
+    const int32_t level = stream->s_stack;
+    enum judo_result result;
+
+    do
+    {
+        result = scan_token(scanner);
+    } while ((result == JUDO_RESULT_SUCCESS) && ((stream->s_stack != level) || (get_state(stream) != SCAN_STATE_FINISHED_PARSING_VALUE)));
+
+    return result;
+}
+
+enum judo_result judo_scan_skip(struct judo_stream *stream, const char *source, judo_size length, uint32_t flags) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    struct scanner scanner;
+    enum judo_result result = init_scanner(&scanner, stream, source, length);
+
+    if (result == JUDO_RESULT_SUCCESS)
+    {
+        if ((stream->token != JUDO_TOKEN_ARRAY_BEGIN) && (stream->token != JUDO_TOKEN_OBJECT_BEGIN))
+        {
+            result = JUDO_RESULT_INVALID_OPERATION;
+        }
+        else if ((flags & JUDO_SKIP_RELAXED) != 0u)
+        {
+            judo_size deepest = 0;
+            stream->escaped = false;
+            stream->numtype = JUDO_NUMTYPE_INVALID;
+            stream->digits = 0;
+            result = skip_relaxed(&scanner, (judo_size)max_depth(stream) - (judo_size)stream->s_stack, &deepest);
             stream->s_at = scanner.index;
         }
+        else
+        {
+            result = skip_tokens(&scanner);
+        }
+    }
+
+    return result;
+}
+
+judo_size judo_nesting(const struct judo_stream *stream, const char *source, judo_size length)
+{
+    // The copy is skipped rather than the stream. Counting brackets never pushes the kinds of the
+    // levels it passes so the copy needn't have room for them.
+    struct judo_stream copy = *stream;
+    struct scanner scanner;
+    judo_size deepest = 0;
+
+    if (init_scanner(&scanner, &copy, source, length) == JUDO_RESULT_SUCCESS)
+    {
+        // A value can't nest deeper than it has bytes so the limit is never reached.
+        (void)skip_relaxed(&scanner, scanner.string_length + 1, &deepest);
+    }
+
+    return deepest;
+}
+
+enum judo_result judo_setdepth(struct judo_stream *stream, void *stack, int32_t depth) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+
+    if (stream == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (depth <= stream->s_stack)
+    {
+        // The depth cannot be lowered beneath the current nesting of the scanner.
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if ((stack == NULL) && (depth > JUDO_MAXDEPTH))
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        uint8_t *spill = (depth > JUDO_MAXDEPTH) ? (uint8_t *)stack : NULL; // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+
+        // Copy the kinds of the levels which spilled into the previous stack.
+        if ((spill != NULL) && (stream->s_spill != NULL) && (spill != stream->s_spill) && (stream->s_stack >= JUDO_MAXDEPTH))
+        {
+            (void)memcpy(spill, stream->s_spill, ((size_t)(stream->s_stack - JUDO_MAXDEPTH) / 8u) + 1u);
+        }
+
+        stream->s_spill = spill;
+        stream->s_depth = depth;
+    }
+
+    return result;
+}
+
+size_t judo_stacksize(int32_t depth) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    return (depth > JUDO_MAXDEPTH) ? ((((size_t)depth - (size_t)JUDO_MAXDEPTH) + 7u) / 8u) : 0u;
+}
+
+enum judo_result judo_prevalidate(struct judo_stream *stream, const char *source, judo_size length) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    judo_size source_length = 0;
+
+    if (stream == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (source == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (!measure_input(stream, source, length, &source_length))
+    {
+        result = JUDO_RESULT_INPUT_TOO_LARGE;
+    }
+    else
+    {
+        // The input length is valid.
+    }
+
+    if (result == JUDO_RESULT_SUCCESS)
+    {
+        // The stream is left untouched when validation fails so that judo_scan()
+        // can report the precise location of the malformed character.
+        if (utf8_validate((const uint8_t *)source, source_length))
+        {
+            stream->s_flags |= STREAM_PREVALIDATED;
+            if (length < 0)
+            {
+                stream->s_length = source_length;
+                stream->s_flags |= STREAM_MEASURED;
+            }
+        }
+        else
+        {
+            result = JUDO_RESULT_ILLEGAL_BYTE_SEQUENCE;
+        }
+    }
+
+    return result;
+}
+
+enum judo_result judo_scan_push(struct judo_stream *stream, const char *window, judo_size offset, judo_size length, bool final) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+
+    if (stream == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (window == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if ((offset < 0) || (length < 0))
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (length >= (JUDO_MAXIMUM_INPUT_SIZE - offset))
+    {
+        result = bad_input_size(stream);
+    }
+    else if ((offset > stream->s_at) || ((offset + length) < stream->s_at))
+    {
+        // The window must include the byte where the scanner left off.
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        // The scanner operates on offsets relative to the window
+        // which are translated into absolute offsets afterwards.
+        struct scanner scanner;
+        scanner.stream = stream;
+        scanner.string = (const uint8_t *)window;
+        scanner.string_length = length;
+        scanner.index = stream->s_at - offset;
+        scanner.trusted = false;
+        scanner.extent = scanner.index;
+        scanner.string_start = -1;
+        scanner.string_resume = 0;
+        scanner.string_escaped = false;
+        if ((stream->s_flags & STREAM_RESUMABLE) != 0u)
+        {
+            // The previous window ended inside a string so lexing resumes where it left off.
+            scanner.string_start = stream->s_string - offset;
+            scanner.string_resume = stream->s_resume - offset;
+            scanner.string_escaped = (stream->s_flags & STREAM_ESCAPED) != 0u;
+        }
+        stream->s_flags &= (uint8_t)~(STREAM_RESUMABLE | STREAM_ESCAPED);
+        stream->where.offset -= offset;
+
+        if (final)
+        {
+            result = scan_token(&scanner);
+            stream->s_at = offset + scanner.index;
+            stream->where.offset += offset;
+        }
+        else
+        {
+            // Scanning is speculative since the end of the window is not the end of the input.
+            // If the outcome might depend on bytes beyond the window, then the stream is reverted.
+            struct judo_stream saved;
+            (void)memcpy(&saved, stream, sizeof(saved));
+            saved.where.offset += offset;
+
+            result = scan_token(&scanner);
+
+            // Whatever span is reported, the outcome might change if lexing reached the end of the window.
+            judo_size horizon = scanner.index;
+            if (scanner.extent > horizon)
+            {
+                horizon = scanner.extent;
+            }
+            if ((stream->where.offset + stream->where.length) > horizon)
+            {
+                horizon = stream->where.offset + stream->where.length;
+            }
+
+            if (horizon >= (length - PUSH_LOOKAHEAD))
+            {
+                (void)memcpy(stream, &saved, sizeof(saved));
+                stream->where = (struct judo_span){stream->s_at, 0};
+                stream->token = JUDO_TOKEN_INVALID;
+                result = JUDO_RESULT_NEED_MORE;
+
+                // Remember how much of an unclosed string was lexed so the next window needn't rescan it.
+                if (scanner.string_start >= 0)
+                {
+                    stream->s_string = offset + scanner.string_start;
+                    stream->s_resume = offset + scanner.string_resume;
+                    stream->s_flags |= STREAM_RESUMABLE;
+                    if (scanner.string_escaped)
+                    {
+                        stream->s_flags |= STREAM_ESCAPED;
+                    }
+                }
+            }
+            else
+            {
+                stream->s_at = offset + scanner.index;
+                stream->where.offset += offset;
+            }
+        }
     }
 
     return result;
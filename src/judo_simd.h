@@ -0,0 +1,375 @@
+/*
+ *  Judo - Embeddable JSON and JSON5 parser.
+ *  Copyright (c) 2025 Railgun Labs, LLC
+ *
+ *  This software is dual-licensed: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3 as
+ *  published by the Free Software Foundation. For the terms of this
+ *  license, see <https://www.gnu.org/licenses/>.
+ *
+ *  Alternatively, you can license this software under a proprietary
+ *  license, as set out in <https://railgunlabs.com/judo/license/>.
+ */
+
+// The scanner optionally processes blocks of bytes with SIMD instructions.
+// The instruction set is selected at compile-time from the target architecture
+// and the feature is only active when Judo is configured with SIMD enabled.
+// Every vectorized code path has a scalar counterpart which is used when no
+// supported instruction set is available.
+//
+// Each comparison on a block produces a bit mask where bit N corresponds with
+// byte N of the block. This keeps the vectorized algorithms independent of
+// the underlying instruction set.
+//
+// Instruction sets with a byte shuffle additionally define JUDO_SIMD_LOOKUP
+// and provide element-wise operations for table-driven algorithms.
+//
+// This file does not attempt to be MISRA compliant: vector intrinsics are
+// outside the scope of the standard. Configure Judo with SIMD disabled if
+// strict conformance is required.
+
+#ifndef JUDO_SIMD_H
+#define JUDO_SIMD_H
+
+#include "judo_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(JUDO_WITH_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define JUDO_SIMD_AVX2
+#define JUDO_SIMD_WIDTH 32
+#define JUDO_SIMD_LOOKUP
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define JUDO_SIMD_SSE2
+#define JUDO_SIMD_WIDTH 16
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define JUDO_SIMD_LOOKUP
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define JUDO_SIMD_NEON
+#define JUDO_SIMD_WIDTH 16
+#define JUDO_SIMD_LOOKUP
+#endif
+#endif
+
+#if defined(JUDO_SIMD_WIDTH)
+
+#if JUDO_SIMD_WIDTH == 32
+#define SIMD_MASK_ALL UINT32_C(0xFFFFFFFF)
+#else
+#define SIMD_MASK_ALL UINT32_C(0xFFFF)
+#endif
+
+#if defined(JUDO_SIMD_AVX2)
+typedef __m256i simd_block;
+
+static inline simd_block simd_load(const uint8_t *bytes)
+{
+    return _mm256_loadu_si256((const __m256i *)bytes);
+}
+
+static inline uint32_t simd_eq(simd_block block, uint8_t c)
+{
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8((char)c)));
+}
+
+// Unsigned less-than-or-equal comparison.
+static inline uint32_t simd_le(simd_block block, uint8_t c)
+{
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(block, _mm256_set1_epi8((char)c)), block));
+}
+
+// Bytes with their high bit set, i.e. bytes which are not ASCII.
+static inline uint32_t simd_nonascii(simd_block block)
+{
+    return (uint32_t)_mm256_movemask_epi8(block);
+}
+
+static inline simd_block simd_zero(void)
+{
+    return _mm256_setzero_si256();
+}
+
+// Loads a 16 byte lookup table into each 128-bit lane.
+static inline simd_block simd_table(const uint8_t table[16])
+{
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)table));
+}
+
+// Each byte of the result is the table entry indexed by the corresponding byte (0 to 15) of the indices.
+static inline simd_block simd_lookup(simd_block table, simd_block indices)
+{
+    return _mm256_shuffle_epi8(table, indices);
+}
+
+static inline simd_block simd_high_nibbles(simd_block block)
+{
+    return _mm256_and_si256(_mm256_srli_epi16(block, 4), _mm256_set1_epi8(0x0F));
+}
+
+static inline simd_block simd_low_nibbles(simd_block block)
+{
+    return _mm256_and_si256(block, _mm256_set1_epi8(0x0F));
+}
+
+static inline simd_block simd_and(simd_block a, simd_block b)
+{
+    return _mm256_and_si256(a, b);
+}
+
+static inline simd_block simd_or(simd_block a, simd_block b)
+{
+    return _mm256_or_si256(a, b);
+}
+
+static inline simd_block simd_xor(simd_block a, simd_block b)
+{
+    return _mm256_xor_si256(a, b);
+}
+
+static inline simd_block simd_splat(uint8_t c)
+{
+    return _mm256_set1_epi8((char)c);
+}
+
+// Unsigned saturating subtraction.
+static inline simd_block simd_subs(simd_block a, simd_block b)
+{
+    return _mm256_subs_epu8(a, b);
+}
+
+// The block shifted N bytes "right" with the trailing bytes of the previous block shifted in.
+static inline simd_block simd_prev1(simd_block block, simd_block prev)
+{
+    return _mm256_alignr_epi8(block, _mm256_permute2x128_si256(prev, block, 0x21), 15);
+}
+
+static inline simd_block simd_prev2(simd_block block, simd_block prev)
+{
+    return _mm256_alignr_epi8(block, _mm256_permute2x128_si256(prev, block, 0x21), 14);
+}
+
+static inline simd_block simd_prev3(simd_block block, simd_block prev)
+{
+    return _mm256_alignr_epi8(block, _mm256_permute2x128_si256(prev, block, 0x21), 13);
+}
+
+static inline bool simd_any(simd_block block)
+{
+    return _mm256_testz_si256(block, block) == 0;
+}
+#elif defined(JUDO_SIMD_SSE2)
+typedef __m128i simd_block;
+
+static inline simd_block simd_load(const uint8_t *bytes)
+{
+    return _mm_loadu_si128((const __m128i *)bytes);
+}
+
+static inline uint32_t simd_eq(simd_block block, uint8_t c)
+{
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8((char)c)));
+}
+
+// Unsigned less-than-or-equal comparison.
+static inline uint32_t simd_le(simd_block block, uint8_t c)
+{
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(block, _mm_set1_epi8((char)c)), block));
+}
+
+// Bytes with their high bit set, i.e. bytes which are not ASCII.
+static inline uint32_t simd_nonascii(simd_block block)
+{
+    return (uint32_t)_mm_movemask_epi8(block);
+}
+
+#if defined(JUDO_SIMD_LOOKUP)
+static inline simd_block simd_zero(void)
+{
+    return _mm_setzero_si128();
+}
+
+static inline simd_block simd_table(const uint8_t table[16])
+{
+    return _mm_loadu_si128((const __m128i *)table);
+}
+
+// Each byte of the result is the table entry indexed by the corresponding byte (0 to 15) of the indices.
+static inline simd_block simd_lookup(simd_block table, simd_block indices)
+{
+    return _mm_shuffle_epi8(table, indices);
+}
+
+static inline simd_block simd_high_nibbles(simd_block block)
+{
+    return _mm_and_si128(_mm_srli_epi16(block, 4), _mm_set1_epi8(0x0F));
+}
+
+static inline simd_block simd_low_nibbles(simd_block block)
+{
+    return _mm_and_si128(block, _mm_set1_epi8(0x0F));
+}
+
+static inline simd_block simd_and(simd_block a, simd_block b)
+{
+    return _mm_and_si128(a, b);
+}
+
+static inline simd_block simd_or(simd_block a, simd_block b)
+{
+    return _mm_or_si128(a, b);
+}
+
+static inline simd_block simd_xor(simd_block a, simd_block b)
+{
+    return _mm_xor_si128(a, b);
+}
+
+static inline simd_block simd_splat(uint8_t c)
+{
+    return _mm_set1_epi8((char)c);
+}
+
+// Unsigned saturating subtraction.
+static inline simd_block simd_subs(simd_block a, simd_block b)
+{
+    return _mm_subs_epu8(a, b);
+}
+
+// The block shifted N bytes "right" with the trailing bytes of the previous block shifted in.
+static inline simd_block simd_prev1(simd_block block, simd_block prev)
+{
+    return _mm_alignr_epi8(block, prev, 15);
+}
+
+static inline simd_block simd_prev2(simd_block block, simd_block prev)
+{
+    return _mm_alignr_epi8(block, prev, 14);
+}
+
+static inline simd_block simd_prev3(simd_block block, simd_block prev)
+{
+    return _mm_alignr_epi8(block, prev, 13);
+}
+
+static inline bool simd_any(simd_block block)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_setzero_si128())) != 0xFFFF;
+}
+#endif
+#elif defined(JUDO_SIMD_NEON)
+typedef uint8x16_t simd_block;
+
+// NEON has no equivalent to the x86 "movemask" instruction so it's emulated by
+// weighting each lane by its bit position and summing each half of the vector.
+static inline uint32_t simd_movemask(uint8x16_t lanes)
+{
+    static const uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t masked = vandq_u8(lanes, vld1q_u8(weights));
+    return (uint32_t)vaddv_u8(vget_low_u8(masked)) | ((uint32_t)vaddv_u8(vget_high_u8(masked)) << 8);
+}
+
+static inline simd_block simd_load(const uint8_t *bytes)
+{
+    return vld1q_u8(bytes);
+}
+
+static inline uint32_t simd_eq(simd_block block, uint8_t c)
+{
+    return simd_movemask(vceqq_u8(block, vdupq_n_u8(c)));
+}
+
+// Unsigned less-than-or-equal comparison.
+static inline uint32_t simd_le(simd_block block, uint8_t c)
+{
+    return simd_movemask(vcleq_u8(block, vdupq_n_u8(c)));
+}
+
+// Bytes with their high bit set, i.e. bytes which are not ASCII.
+static inline uint32_t simd_nonascii(simd_block block)
+{
+    return simd_movemask(vcgeq_u8(block, vdupq_n_u8(0x80)));
+}
+
+static inline simd_block simd_zero(void)
+{
+    return vdupq_n_u8(0);
+}
+
+static inline simd_block simd_table(const uint8_t table[16])
+{
+    return vld1q_u8(table);
+}
+
+// Each byte of the result is the table entry indexed by the corresponding byte (0 to 15) of the indices.
+static inline simd_block simd_lookup(simd_block table, simd_block indices)
+{
+    return vqtbl1q_u8(table, indices);
+}
+
+static inline simd_block simd_high_nibbles(simd_block block)
+{
+    return vshrq_n_u8(block, 4);
+}
+
+static inline simd_block simd_low_nibbles(simd_block block)
+{
+    return vandq_u8(block, vdupq_n_u8(0x0F));
+}
+
+static inline simd_block simd_and(simd_block a, simd_block b)
+{
+    return vandq_u8(a, b);
+}
+
+static inline simd_block simd_or(simd_block a, simd_block b)
+{
+    return vorrq_u8(a, b);
+}
+
+static inline simd_block simd_xor(simd_block a, simd_block b)
+{
+    return veorq_u8(a, b);
+}
+
+static inline simd_block simd_splat(uint8_t c)
+{
+    return vdupq_n_u8(c);
+}
+
+// Unsigned saturating subtraction.
+static inline simd_block simd_subs(simd_block a, simd_block b)
+{
+    return vqsubq_u8(a, b);
+}
+
+// The block shifted N bytes "right" with the trailing bytes of the previous block shifted in.
+static inline simd_block simd_prev1(simd_block block, simd_block prev)
+{
+    return vextq_u8(prev, block, 15);
+}
+
+static inline simd_block simd_prev2(simd_block block, simd_block prev)
+{
+    return vextq_u8(prev, block, 14);
+}
+
+static inline simd_block simd_prev3(simd_block block, simd_block prev)
+{
+    return vextq_u8(prev, block, 13);
+}
+
+static inline bool simd_any(simd_block block)
+{
+    return vmaxvq_u8(block) != 0u;
+}
+#endif
+
+#endif
+
+#endif
@@ -15,9 +15,20 @@
 // by the command-line interface and Judo examples. This code does not
 // attempt to be MISRA compliant.
 
+#include "judo_config.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+
+// Limit the input to 10 megabytes to avoid integer overflow elsewhere in the implementation.
+// This also ensures the buffer capacity remains under the maximum signed 32-bit integer.
+// With 64-bit spans the input is only limited by the address space.
+#if defined(JUDO_WIDE_SPANS)
+#define READ_LIMIT (SIZE_MAX / 2u)
+#else
+#define READ_LIMIT ((size_t)1024 * 1024 * 10)
+#endif
 
 #if defined(_WIN32)
 #include <io.h>
@@ -55,19 +66,28 @@ char *judo_readstdin(size_t *size)
         }
 
         const size_t buffer_length = (size_t)bytes_read;
-        const size_t new_capacity = dynbuf_length + buffer_length;
+        const size_t new_length = dynbuf_length + buffer_length;
 
-        // Limit the input to 10 megabytes to avoid integer overflow elsewhere in the implementation.
-        // This also ensures the buffer capacity remains under the maximum signed 32-bit integer.
-        if (new_capacity >= 1024 * 1024 * 10)
+        if (new_length >= READ_LIMIT)
         {
             fprintf(stderr, "error: input too large\n");
             free(dynbuf);
             return NULL;
         }
 
-        if (new_capacity >= dynbuf_capacity)
+        if (new_length >= dynbuf_capacity)
         {
+            // Grow geometrically so large inputs aren't copied with every read.
+            size_t new_capacity = (dynbuf_capacity < sizeof(buffer)) ? sizeof(buffer) : dynbuf_capacity;
+            while (new_capacity <= new_length)
+            {
+                new_capacity *= 2u;
+            }
+            if (new_capacity > READ_LIMIT)
+            {
+                new_capacity = READ_LIMIT;
+            }
+
             char *tmpbuf = realloc(dynbuf, new_capacity);
             if (tmpbuf == NULL)
             {
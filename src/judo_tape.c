@@ -0,0 +1,497 @@
+/*
+ *  Judo - Embeddable JSON and JSON5 parser.
+ *  Copyright (c) 2025 Railgun Labs, LLC
+ *
+ *  This software is dual-licensed: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 3 as
+ *  published by the Free Software Foundation. For the terms of this
+ *  license, see <https://www.gnu.org/licenses/>.
+ *
+ *  Alternatively, you can license this software under a proprietary
+ *  license, as set out in <https://railgunlabs.com/judo/license/>.
+ */
+
+// This file implements an alternative to the linked tree built by judo_parse().
+// The "tape" is a single array of fixed-size entries in document order. Values
+// are referenced by their index in the array rather than by pointer. The first
+// element or member of a container immediately follows it and the container is
+// closed by an end entry. A container and its end entry store each other's index
+// so that its subtree is skipped by jumping past its end.
+//
+// Object members occupy two entries: the member name followed by its value.
+
+#include "judo.h"
+
+#if defined(JUDO_PARSER)
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+// Number of tokens scanned at a time when building the tape.
+#define SCAN_BATCH_SIZE 32
+
+// Number of entries allocated when the first token is recorded.
+#define INITIAL_CAPACITY 64
+
+// Entry types for member names and for the ends of containers. They're distinct from the JSON value types.
+#define TAPE_MEMBER 0xFFu
+#define TAPE_END 0xFEu
+
+struct tape_entry
+{
+    struct judo_span where;
+    judo_size end; // Index of the end entry of a container or, for an end entry, the index of its container.
+    judo_size count; // Number of elements or members of a container or the value of a boolean.
+    uint8_t type;
+};
+
+struct tape_builder
+{
+    struct tape_entry *entries;
+    judo_size count;
+    judo_size capacity;
+    void *udata;
+    judo_memfunc memfunc;
+    judo_size open; // Index of the innermost open container or -1. Its 'end' links to the container enclosing it until it's closed.
+    int32_t nesting; // Number of open containers.
+    int32_t depth; // Maximum number of levels the document can nest.
+    int32_t depth_capacity; // Number of levels the scanner has room for.
+    void *spill; // State of the scanner for levels deeper than JUDO_MAXDEPTH (or null).
+};
+
+static struct tape_entry *get_entries(const struct judo_tape *tape)
+{
+    return tape->s_entries; // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+}
+
+// Doubles the capacity of the tape. The memory function cannot resize an allocation so
+// the entries are copied into a new allocation.
+static enum judo_result grow(struct tape_builder *builder)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    const judo_size capacity = (builder->capacity == 0) ? INITIAL_CAPACITY : (builder->capacity * 2);
+
+    if ((size_t)capacity > ((SIZE_MAX / 2u) / sizeof(struct tape_entry)))
+    {
+        result = JUDO_RESULT_OUT_OF_MEMORY; // LCOV_EXCL_LINE
+    }
+    else
+    {
+        struct tape_entry *entries = builder->memfunc(builder->udata, NULL, (size_t)capacity * sizeof(entries[0])); // cppcheck-suppress misra-c2012-11.5 ; Cast from void pointer to object pointer.
+        if (entries == NULL)
+        {
+            result = JUDO_RESULT_OUT_OF_MEMORY;
+        }
+        else
+        {
+            if (builder->entries != NULL)
+            {
+                (void)memcpy(entries, builder->entries, (size_t)builder->count * sizeof(entries[0]));
+                (void)builder->memfunc(builder->udata, builder->entries, (size_t)builder->capacity * sizeof(entries[0]));
+            }
+            builder->entries = entries;
+            builder->capacity = capacity;
+        }
+    }
+
+    return result;
+}
+
+// Ensures the scanner has room for the levels a batch of tokens can nest beneath the open containers.
+// Each token nests at most one level deeper and the scanner keeps a level for the root and for the
+// value it's scanning. Levels beyond JUDO_MAXDEPTH are kept in memory from the allocator which grows
+// by doubling so that shallow documents needn't allocate any.
+static enum judo_result reserve_depth(struct tape_builder *builder, struct judo_stream *stream)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+    int32_t needed = builder->depth;
+
+    if (builder->nesting < (builder->depth - (SCAN_BATCH_SIZE + 2)))
+    {
+        needed = builder->nesting + SCAN_BATCH_SIZE + 2;
+    }
+
+    if (needed > builder->depth_capacity)
+    {
+        int32_t capacity = builder->depth_capacity;
+        while (capacity < needed)
+        {
+            capacity = (capacity > (builder->depth / 2)) ? builder->depth : (capacity * 2);
+        }
+
+        void *spill = builder->memfunc(builder->udata, NULL, judo_stacksize(capacity));
+        if (spill == NULL)
+        {
+            result = JUDO_RESULT_OUT_OF_MEMORY;
+        }
+        else
+        {
+            // The scanner copies its state from the previous spill so it must be released afterwards.
+            (void)judo_setdepth(stream, spill, capacity);
+            if (builder->spill != NULL)
+            {
+                (void)builder->memfunc(builder->udata, builder->spill, judo_stacksize(builder->depth_capacity));
+            }
+            builder->spill = spill;
+            builder->depth_capacity = capacity;
+        }
+    }
+    else
+    {
+        // Documents which nest no deeper than JUDO_MAXDEPTH needn't grow but the depth can be lower.
+        (void)judo_setdepth(stream, builder->spill, builder->depth_capacity);
+    }
+
+    return result;
+}
+
+// Appends an entry to the tape and counts it as an element or member of its container.
+static enum judo_result append(struct tape_builder *builder, uint8_t type, struct judo_span where)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+
+    if (builder->count == builder->capacity)
+    {
+        result = grow(builder);
+    }
+
+    if (result == JUDO_RESULT_SUCCESS)
+    {
+        const judo_size at = builder->count;
+        struct tape_entry *entry = &builder->entries[at];
+        entry->where = where;
+        entry->end = 0;
+        entry->count = 0;
+        entry->type = type;
+        builder->count += 1;
+
+        if ((builder->open >= 0) && (type != (uint8_t)TAPE_END))
+        {
+            struct tape_entry *container = &builder->entries[builder->open];
+
+            // Member values aren't counted since they immediately follow their name.
+            if ((container->type == (uint8_t)JUDO_TYPE_ARRAY) || (type == (uint8_t)TAPE_MEMBER))
+            {
+                container->count += 1;
+            }
+        }
+    }
+
+    return result;
+}
+
+static enum judo_result record(struct tape_builder *builder, const struct judo_item *item)
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+
+    switch (item->token)
+    {
+    case JUDO_TOKEN_NULL:
+        result = append(builder, (uint8_t)JUDO_TYPE_NULL, item->where);
+        break;
+
+    case JUDO_TOKEN_TRUE:
+    case JUDO_TOKEN_FALSE:
+        result = append(builder, (uint8_t)JUDO_TYPE_BOOL, item->where);
+        if (result == JUDO_RESULT_SUCCESS)
+        {
+            builder->entries[builder->count - 1].count = (item->token == JUDO_TOKEN_TRUE) ? 1 : 0;
+        }
+        break;
+
+    case JUDO_TOKEN_NUMBER:
+        result = append(builder, (uint8_t)JUDO_TYPE_NUMBER, item->where);
+        break;
+
+    case JUDO_TOKEN_STRING:
+        result = append(builder, (uint8_t)JUDO_TYPE_STRING, item->where);
+        break;
+
+    case JUDO_TOKEN_OBJECT_NAME:
+        result = append(builder, (uint8_t)TAPE_MEMBER, item->where);
+        break;
+
+    case JUDO_TOKEN_ARRAY_BEGIN:
+    case JUDO_TOKEN_OBJECT_BEGIN:
+        assert(builder->nesting < builder->depth_capacity); // LCOV_EXCL_BR_LINE
+        result = append(builder, (item->token == JUDO_TOKEN_ARRAY_BEGIN) ? (uint8_t)JUDO_TYPE_ARRAY : (uint8_t)JUDO_TYPE_OBJECT, item->where);
+        if (result == JUDO_RESULT_SUCCESS)
+        {
+            builder->entries[builder->count - 1].end = builder->open;
+            builder->open = builder->count - 1;
+            builder->nesting += 1;
+        }
+        break;
+
+    case JUDO_TOKEN_ARRAY_END:
+    case JUDO_TOKEN_OBJECT_END:
+        assert(builder->open >= 0); // LCOV_EXCL_BR_LINE
+        result = append(builder, (uint8_t)TAPE_END, item->where);
+        if (result == JUDO_RESULT_SUCCESS)
+        {
+            const judo_size end = builder->count - 1;
+            struct tape_entry *container = &builder->entries[builder->open];
+            container->where.length = (item->where.offset + item->where.length) - container->where.offset;
+            builder->entries[end].end = builder->open;
+            builder->open = container->end;
+            container->end = end;
+            builder->nesting -= 1;
+        }
+        break;
+
+    default:
+        assert(item->token == JUDO_TOKEN_EOF); // LCOV_EXCL_BR_LINE
+        break;
+    }
+
+    return result;
+}
+
+enum judo_result judo_parsetapedepth(const char *source, judo_size length, struct judo_tape *tape, struct judo_error *error, void *udata, judo_memfunc memfunc, int32_t depth) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result;
+
+    if (tape == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (depth <= 0)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+        (void)memset(tape, 0, sizeof(tape[0]));
+    }
+    else if (source == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+        (void)memset(tape, 0, sizeof(tape[0]));
+    }
+    else if (memfunc == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+        (void)memset(tape, 0, sizeof(tape[0]));
+    }
+    else
+    {
+        struct judo_stream stream = {0};
+        struct tape_builder builder = {
+            .udata = udata,
+            .memfunc = memfunc,
+            .open = -1,
+            .depth = depth,
+            .depth_capacity = (depth < JUDO_MAXDEPTH) ? depth : JUDO_MAXDEPTH,
+        };
+
+        struct judo_item items[SCAN_BATCH_SIZE];
+        struct judo_span where = {0, 0};
+        do
+        {
+            // Tokens scanned before an error are recorded first so that an out-of-memory
+            // error is reported for the same token it would be if they were scanned one by one.
+            int32_t count = 0;
+            enum judo_result scanned = reserve_depth(&builder, &stream);
+            if (scanned == JUDO_RESULT_SUCCESS)
+            {
+                scanned = judo_scan_many(&stream, source, length, items, SCAN_BATCH_SIZE, &count);
+            }
+            result = JUDO_RESULT_SUCCESS;
+            for (int32_t i = 0; (i < count) && (result == JUDO_RESULT_SUCCESS); i++)
+            {
+                result = record(&builder, &items[i]);
+                where = items[i].where;
+            }
+
+            if (result == JUDO_RESULT_SUCCESS)
+            {
+                result = scanned;
+                where = stream.where;
+            }
+        } while ((result == JUDO_RESULT_SUCCESS) && (stream.token != JUDO_TOKEN_EOF));
+
+        if (result == JUDO_RESULT_SUCCESS)
+        {
+            tape->s_entries = builder.entries;
+            tape->s_count = builder.count;
+            tape->s_capacity = builder.capacity;
+
+            if (error != NULL)
+            {
+                (void)memset(error, 0, sizeof(error[0]));
+            }
+        }
+        else
+        {
+            if (error != NULL)
+            {
+                if (result == JUDO_RESULT_OUT_OF_MEMORY)
+                {
+                    (void)memcpy(error->description, "memory allocation failed", 25);
+                }
+                else
+                {
+                    (void)memcpy(error->description, stream.error, JUDO_ERRMAX);
+                }
+                error->where = where;
+            }
+
+            if (builder.entries != NULL)
+            {
+                (void)memfunc(udata, builder.entries, (size_t)builder.capacity * sizeof(builder.entries[0]));
+            }
+            (void)memset(tape, 0, sizeof(tape[0]));
+        }
+
+        if (builder.spill != NULL)
+        {
+            (void)memfunc(udata, builder.spill, judo_stacksize(builder.depth_capacity));
+        }
+    }
+
+    return result;
+}
+
+enum judo_result judo_parsetape(const char *source, judo_size length, struct judo_tape *tape, struct judo_error *error, void *udata, judo_memfunc memfunc) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    return judo_parsetapedepth(source, length, tape, error, udata, memfunc, JUDO_MAXDEPTH);
+}
+
+enum judo_result judo_freetape(struct judo_tape *tape, void *udata, judo_memfunc memfunc) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_result result = JUDO_RESULT_SUCCESS;
+
+    if (tape == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else if (memfunc == NULL)
+    {
+        result = JUDO_RESULT_INVALID_OPERATION;
+    }
+    else
+    {
+        if (tape->s_entries != NULL)
+        {
+            (void)memfunc(udata, tape->s_entries, (size_t)tape->s_capacity * sizeof(struct tape_entry));
+        }
+        (void)memset(tape, 0, sizeof(tape[0]));
+    }
+
+    return result;
+}
+
+static const struct tape_entry *get_entry(const struct judo_tape *tape, judo_size at)
+{
+    const struct tape_entry *entry = NULL;
+    if ((tape != NULL) && (at >= 0) && (at < tape->s_count))
+    {
+        entry = &get_entries(tape)[at];
+    }
+    return entry;
+}
+
+enum judo_type judo_tapetype(const struct judo_tape *tape, judo_size at) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    enum judo_type type = JUDO_TYPE_INVALID;
+    const struct tape_entry *entry = get_entry(tape, at);
+    if ((entry != NULL) && (entry->type != (uint8_t)TAPE_MEMBER) && (entry->type != (uint8_t)TAPE_END))
+    {
+        type = (enum judo_type)entry->type;
+    }
+    return type;
+}
+
+judo_size judo_tapefirst(const struct judo_tape *tape, judo_size at) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    judo_size first = -1;
+    const struct tape_entry *entry = get_entry(tape, at);
+    if (entry != NULL)
+    {
+        if ((entry->type == (uint8_t)JUDO_TYPE_ARRAY) || (entry->type == (uint8_t)JUDO_TYPE_OBJECT))
+        {
+            if (entry->count > 0)
+            {
+                first = at + 1;
+            }
+        }
+    }
+    return first;
+}
+
+judo_size judo_tapenext(const struct judo_tape *tape, judo_size at) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    judo_size next = -1;
+    const struct tape_entry *entry = get_entry(tape, at);
+
+    // Member values have no siblings of their own since they immediately follow their name.
+    if ((entry != NULL) && (entry->type != (uint8_t)TAPE_END) && (judo_tapevalue(tape, at - 1) != at))
+    {
+        const struct tape_entry *entries = get_entries(tape);
+        judo_size after = at;
+
+        // The value of a member is skipped along with its name.
+        if (entry->type == (uint8_t)TAPE_MEMBER)
+        {
+            after += 1;
+        }
+
+        // Arrays and objects are skipped by jumping past their end.
+        if ((entries[after].type == (uint8_t)JUDO_TYPE_ARRAY) || (entries[after].type == (uint8_t)JUDO_TYPE_OBJECT))
+        {
+            after = entries[after].end;
+        }
+        after += 1;
+
+        if ((after < tape->s_count) && (entries[after].type != (uint8_t)TAPE_END))
+        {
+            next = after;
+        }
+    }
+    return next;
+}
+
+judo_size judo_tapevalue(const struct judo_tape *tape, judo_size member) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    judo_size value = -1;
+    const struct tape_entry *entry = get_entry(tape, member);
+    if ((entry != NULL) && (entry->type == (uint8_t)TAPE_MEMBER))
+    {
+        value = member + 1;
+    }
+    return value;
+}
+
+bool judo_tapebool(const struct judo_tape *tape, judo_size at) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    bool b = false;
+    const struct tape_entry *entry = get_entry(tape, at);
+    if ((entry != NULL) && (entry->type == (uint8_t)JUDO_TYPE_BOOL))
+    {
+        b = (entry->count != 0) ? true : false;
+    }
+    return b;
+}
+
+judo_size judo_tapelen(const struct judo_tape *tape, judo_size at) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    judo_size length = 0;
+    const struct tape_entry *entry = get_entry(tape, at);
+    if (entry != NULL)
+    {
+        if ((entry->type == (uint8_t)JUDO_TYPE_ARRAY) || (entry->type == (uint8_t)JUDO_TYPE_OBJECT))
+        {
+            length = entry->count;
+        }
+    }
+    return length;
+}
+
+struct judo_span judo_tapespan(const struct judo_tape *tape, judo_size at) // cppcheck-suppress misra-c2012-8.7 ; Public function must have external linkage.
+{
+    struct judo_span span = {0};
+    const struct tape_entry *entry = get_entry(tape, at);
+    if (entry != NULL)
+    {
+        span = entry->where;
+    }
+    return span;
+}
+#endif
@@ -14,13 +14,89 @@
 #ifndef JUDO_UTILS_H
 #define JUDO_UTILS_H
 
-#include "judo_config.h"
+#include "judo.h"
 #include <stdint.h>
 
 #define UNICHAR_C(C) ((unichar)(C))
 
 typedef uint32_t unichar;
 
+// Limit the maximum input size to 1 GB unless offsets are 64-bit.
+#ifndef JUDO_MAXIMUM_INPUT_SIZE
+#if defined(JUDO_WIDE_SPANS)
+#define JUDO_MAXIMUM_INPUT_SIZE (judo_size)0x4000000000000000
+#else
+#define JUDO_MAXIMUM_INPUT_SIZE (judo_size)0x40000000
+#endif
+#endif
+
+// Index of the lowest set bit. The mask must be non-zero.
+static inline int32_t judo_ctz(uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (int32_t)__builtin_ctz(mask);
+#else
+    int32_t index = 0;
+    uint32_t bits = mask;
+    while ((bits & 1u) == 0u)
+    {
+        bits >>= 1u;
+        index += 1;
+    }
+    return index;
+#endif
+}
+
+// Number of set bits in the mask.
+static inline int32_t judo_popcount(uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (int32_t)__builtin_popcount(mask);
+#else
+    uint32_t bits = mask - ((mask >> 1u) & UINT32_C(0x55555555));
+    bits = (bits & UINT32_C(0x33333333)) + ((bits >> 2u) & UINT32_C(0x33333333));
+    bits = (bits + (bits >> 4u)) & UINT32_C(0x0F0F0F0F);
+    return (int32_t)((bits * UINT32_C(0x01010101)) >> 24u);
+#endif
+}
+
+// Decodes the character of a string lexeme, or JSON5 identifier, at '*index' and advances the index
+// past it. The character is written to 'bytes' as UTF-8 and the number of bytes written is returned.
+// Zero is returned at the end of the lexeme. Pass zero as the initial index. The lexeme must have
+// been accepted by the scanner.
+int32_t judo_unescape(const char *lexeme, judo_size length, judo_size *index, char bytes[4]);
+
+// Checks if a string lexeme, or JSON5 identifier, has no escape sequences. If it doesn't, then
+// 'content' is the span of the lexeme without quotes which is identical to the decoded string.
+bool judo_verbatim(const char *lexeme, judo_size length, struct judo_span *content);
+
+// Compares the decoded string lexeme, or JSON5 identifier, with 'key'.
+bool judo_nameeq(const char *lexeme, judo_size length, const char *key, judo_size keylen);
+
+// Counts how many levels the array or object at the current token of the stream nests, itself
+// included, by matching its brackets without validating it. The stream isn't modified. If the
+// value is malformed, then the count only covers the part preceding the defect.
+judo_size judo_nesting(const struct judo_stream *stream, const char *source, judo_size length);
+
+#if defined(JUDO_HAVE_FLOATS)
+// Converts a decimal number lexeme, accepted by the scanner, to the nearest judo_number with
+// ties rounded to even. Returns JUDO_RESULT_OUT_OF_RANGE if the magnitude is too large.
+enum judo_result judo_atof(const char *lexeme, judo_size length, judo_number *number);
+#endif
+
+#if defined(JUDO_PARSER)
+// Like judo_arenafunc() but aligns the allocation to 'alignment' which must be a power of two no
+// greater than 16. The memory function of the arena must return memory aligned at least as strictly.
+void *judo_arenaalign(struct judo_arena *arena, size_t size, size_t alignment);
+
+// Matches the name lexeme of an object member, or the index of an array element, against the children
+// of a step of a projection compiled by judo_projinit(). The matching step is returned or -1 if there is
+// none. Everything beneath a selected step matches the step itself.
+int32_t judo_projmember(const struct judo_projection *projection, int32_t step, const char *lexeme, judo_size length);
+int32_t judo_projelement(const struct judo_projection *projection, int32_t step, judo_size index);
+bool judo_projselected(const struct judo_projection *projection, int32_t step);
+#endif
+
 #if defined(JUDO_JSON5)
 #define IS_SPACE 0x1u
 #define ID_START 0x2u